@@ -10,18 +10,26 @@
 #include <fstream>
 #include <unistd.h>
 #include <cstring>
+#include <cstdlib>
 #include <stdio.h>
 #include <fcntl.h>
 #include <sstream>
 #include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 using namespace std;
 using namespace alioth;
 
 static Manager* pm = nullptr;
+static string server_socket;
+static string trace_file;
 
 int argproc( int argc, char**argv, Manager& manager );
 uistream asker(const string& name, vspace space, const string& app);
+int serve( Manager& manager, const string& sock );
+Jsonz respond( Manager& manager, Jsonz request, bool& quit );
+void writetrace( Manager& manager );
 void writemakefile( string base );
 void pagehelp();
 
@@ -36,17 +44,34 @@ int main( int argc, char **argv ) {
 
     cmd = argproc( argc, argv, manager );
     if( cmd <= 0 ) return cmd;
-    lengine.config(Jsonz::fromJsonStream(*dengine.getIs("lengine.json",Root)));
+    /** 带索引的abon编码由lengine.json生成,若json比编码更新,说明编码已经过时,改为读取json */
+    Dengine::vfd abon, json;
+    Dengine::vmap conf;
+    bool fresh = dengine.statFile("lengine.abon",Root,"",abon);
+    if( fresh and dengine.statFile("lengine.json",Root,"",json) and json.mtim > abon.mtim ) fresh = false;
+    if( fresh ) conf = dengine.mapFile("lengine.abon",Root);
+    if( !conf.good() ) conf = dengine.mapFile("lengine.json",Root);
+    if( conf.good() ) lengine.config(move(conf));
+
+    if( cmd == 3 ) { // compile server
+        lengine.color(false);
+        manager.setResident(true);
+        return serve( manager, server_socket );
+    }
 
     if( cmd == 2 ) { // syntax check
         lengine.color(false);
         lengine.path(false);
         manager.Build( Manager::SYNTAXCHECK, loggers );
-        auto arr = lengine(loggers);
-        Jsonz obj = JObject;
-        obj["cmd"] = "diagnostic";
-        obj["log"] = arr;
-        cout << obj.toJson();
+        JsonzDocument doc;
+        {
+            JsonzDocument::scope active(&doc);
+            auto& obj = doc.root() = Jsonz(JObject);
+            obj["cmd"] = "diagnostic";
+            obj["log"] = lengine(loggers);
+            obj.toJson(cout);
+        }
+        writetrace( manager );
         return 0;
     }
 
@@ -58,7 +83,14 @@ int main( int argc, char **argv ) {
     manager.printModescTable(Root);
     manager.printModescTable(Apps);
 
-    auto output = lengine(loggers);
+    if( auto& pengine = manager.getPerformanceEngine(); pengine.enabled() ) {
+        if( auto os = dengine.getOs("time-report.json",Work|Obj); os ) pengine.report().toJson(*os);
+        else cout << "\033[1;36mwarrning\033[0m: cannot write time report" << endl;
+    }
+    writetrace( manager );
+
+    JsonzDocument doc;
+    auto& output = lengine(loggers,doc);
     output.foreach([&](const Jsonz& j){
         cout << (string)j.at("msg") << endl;
         if( j.test<JArray>("sub") ) j.at("sub").foreach([&](const Jsonz& s){cout << "\t" << (string)s.at("msg") << endl; return true;}); 
@@ -85,6 +117,12 @@ int argproc( int argc, char **argv, Manager& manager ) {
     string cmd_help = "--help";
     string cmd_semantic_check = "--semantic-check";
     string cmd_ask_input = "--ask-input";
+    string cmd_j = "-j";
+    string cmd_jobs = "--jobs";
+    string cmd_server = "--server";
+    string cmd_time_report = "--time-report";
+    string cmd_trace = "--trace";
+    string cmd_to_abon = "--to-abon";
 
     int ret = 1;
 
@@ -93,8 +131,48 @@ int argproc( int argc, char **argv, Manager& manager ) {
     for( auto i = 1; i < argc; i++ ) {
         if( cmd_semantic_check == argv[i] ) {
             ret = 2; // return for syntax check
+        } else if( cmd_time_report == argv[i] ) {
+            manager.getPerformanceEngine().enable(true);
+        } else if( cmd_trace == argv[i] ) {
+            if( !argv[++i] ) {
+                cout << "\033[1;31merror\033[0m: file name missing for option '" << argv[i-1] << "'" << endl;
+                return -1;
+            }
+            trace_file = argv[i];
+            manager.getPerformanceEngine().trace(true);
+        } else if( cmd_to_abon == argv[i] ) {
+            if( !argv[i+1] or !argv[i+2] ) {
+                cout << "\033[1;31merror\033[0m: file name missing for option '" << argv[i] << "'" << endl;
+                return -1;
+            }
+            ifstream is(argv[i+1]);
+            stringstream ss;
+            ss << is.rdbuf();
+            auto src = ss.str();
+            size_t used = 0;
+            auto doc = Jsonz::fromJson(src.data(),src.size(),&used);
+            if( !is or doc.is(JNull) or used != src.size() ) {
+                cout << "\033[1;31merror\033[0m: cannot read json document '" << argv[i+1] << "'" << endl;
+                return -1;
+            }
+            ofstream os(argv[i+2],ios::binary);
+            doc.toAbon(os,2);
+            if( !os ) {
+                cout << "\033[1;31merror\033[0m: cannot write abon document '" << argv[i+2] << "'" << endl;
+                return -1;
+            }
+            return 0;
+        } else if( cmd_server == argv[i] ) {
+            ret = 3; // return for compile server
+            if( argv[i+1] and argv[i+1][0] != '-' ) server_socket = argv[++i];
         } else if( cmd_ask_input == argv[i] ) {
             dengine.setMethodGetIs(asker);
+        } else if( cmd_j == argv[i] or cmd_jobs == argv[i] ) {
+            if( !argv[++i] ) {
+                cout << "\033[1;31merror\033[0m: job count missing for option '" << argv[i-1] << "'" << endl;
+                return -1;
+            }
+            manager.setJobs(atoi(argv[i]));
         } else if( cmd_root == argv[i] or cmd_R == argv[i] ) {
             dengine.setSpacePath(Root,argv[++i]);
         } else if( cmd_work == argv[i] or cmd_W == argv[i] ) {
@@ -138,6 +216,20 @@ int argproc( int argc, char **argv, Manager& manager ) {
     return ret;
 }
 
+/**
+ * @function writetrace : 写出追踪文档
+ * @desc :
+ *  若启用了追踪,将性能引擎中的追踪事件以Chrome追踪事件格式写入指定的文件
+ * @param manager : 管理器
+ */
+void writetrace( Manager& manager ) {
+    auto& pengine = manager.getPerformanceEngine();
+    if( !pengine.tracing() ) return;
+    ofstream os(trace_file);
+    if( os ) pengine.traceEvents().toJson(os);
+    else cout << "\033[1;36mwarrning\033[0m: cannot write trace to '" << trace_file << "'" << endl;
+}
+
 void writemakefile( string base ) {
     cout << " generating makefile to " << base << "makefile" << endl;
     int mfd = open((base+"makefile").data(), O_CREAT|O_WRONLY|O_TRUNC, 0644 );
@@ -183,6 +275,31 @@ void pagehelp() {
         "             specify the \033[1;34mpath\033[0m to work directory\n"
         "                                       by default, it's set to \033[1;34m'./'\033[0m\n"
 
+    "\n"
+    "  -j <\033[1;34mN\033[0m>, --jobs <\033[1;34mN\033[0m>"
+        "                   translate modules into objects with \033[1;34mN\033[0m parallel jobs\n"
+        "                                       if \033[1;34mN\033[0m is 0, use the number of processors\n"
+
+    "\n"
+    "  --server [\033[1;34msocket\033[0m]"
+        "                    run as a resident compile server, taking one json request per line\n"
+        "                                       from stdin, or from the unix \033[1;34msocket\033[0m if specified\n"
+
+    "\n"
+    "  --time-report"
+        "                        record time and memory used by each phase of each module\n"
+        "                                       the report is written to obj/time-report.json\n"
+
+    "\n"
+    "  --trace <\033[1;34mfile\033[0m>"
+        "                     write a chrome trace of the build into \033[1;34mfile\033[0m\n"
+        "                                       spans cover the build, documents, methods and llvm passes\n"
+
+    "\n"
+    "  --to-abon <\033[1;34mjson\033[0m> <\033[1;34mabon\033[0m>"
+        "              convert the \033[1;34mjson\033[0m document into an indexed \033[1;34mabon\033[0m document\n"
+        "                                       used to store the log template catalogue root/lengine.abon\n"
+
     "\n"
     "  -v, -V, --version"
         "                    print the version information of this programm\n"
@@ -220,4 +337,126 @@ uistream asker( const string& name, vspace space, const string& app ) {
     }
 }
 
-#endif
\ No newline at end of file
+/**
+ * @function respond : 应答请求
+ * @desc :
+ *  编译服务的每个请求都是一个json对象
+ *  {"cmd":"build"|"semantic-check"|"exit", "modules":[模块名...]}
+ *  应答同样是一个json对象
+ *  {"cmd":请求的命令, "result":是否成功, "log":日志}
+ * @param manager : 常驻的管理器
+ * @param request : 请求
+ * @param quit : 若请求要求服务退出,此值被设置为true
+ * @return Jsonz : 应答
+ */
+Jsonz respond( Manager& manager, Jsonz request, bool& quit ) {
+    Jsonz answer = JObject;
+    auto& lengine = manager.getLogEngine();
+
+    if( !request.test<JString>("cmd") ) {
+        answer["cmd"] = "error";
+        answer["msg"] = "bad request";
+        return answer;
+    }
+
+    string cmd = request["cmd"];
+    answer["cmd"] = cmd;
+    if( cmd == "exit" ) {
+        quit = true;
+        answer["result"] = true;
+        return answer;
+    } else if( cmd != "build" and cmd != "semantic-check" ) {
+        answer["result"] = false;
+        answer["msg"] = "unknown command '" + cmd + "'";
+        return answer;
+    }
+
+    if( request.test<JArray>("modules") ) request["modules"].foreach([&](Jsonz& m){
+        if( m.is(JString) ) manager.specifyModule((string)m);
+        return true;
+    });
+
+    Lengine::logr loggers;
+    auto& pengine = manager.getPerformanceEngine();
+    bool check = cmd == "semantic-check";
+    lengine.path(!check);
+    pengine.clear();
+    answer["result"] = manager.Build( check?Manager::SYNTAXCHECK:Manager::MACHINECODE, loggers );
+    if( !check ) {
+        manager.printModescTable(Work);
+        manager.printModescTable(Root);
+        manager.printModescTable(Apps);
+    }
+    answer["log"] = lengine(loggers);
+    if( pengine.enabled() ) answer["time-report"] = pengine.report();
+    writetrace( manager );
+    return answer;
+}
+
+/**
+ * @function serve : 运行编译服务
+ * @desc :
+ *  管理器在服务期间常驻,模块描述符表只加载一次,文档的词法分析结果被缓存
+ *  语义引擎中已装载的模块定义被保留,每次请求只重新装载发生了变化的模块
+ *  若未指定套接字,则从标准输入读取请求,向标准输出写入应答
+ *  否则在指定路径上监听unix套接字,依次为每个连接服务
+ * @param manager : 管理器
+ * @param sock : 套接字路径
+ * @return int : 进程返回值
+ */
+int serve( Manager& manager, const string& sock ) {
+    bool quit = false;
+
+    if( sock.empty() ) {
+        string line;
+        while( !quit and getline(cin,line) ) {
+            if( line.empty() ) continue;
+            istringstream is(line);
+            respond(manager,Jsonz::fromJsonStream(is),quit).toJson(cout);
+            cout << endl;
+        }
+        return 0;
+    }
+
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if( sock.size() >= sizeof(addr.sun_path) ) {
+        cout << "\033[1;31merror\033[0m: socket path too long '" << sock << "'" << endl;
+        return 1;
+    }
+    strcpy(addr.sun_path,sock.data());
+    int lfd = socket(AF_UNIX,SOCK_STREAM,0);
+    unlink(sock.data());
+    if( lfd < 0 or bind(lfd,(sockaddr*)&addr,sizeof(addr)) or listen(lfd,4) ) {
+        cout << "\033[1;31merror\033[0m: cannot listen on socket '" << sock << "'" << endl;
+        return 1;
+    }
+
+    while( !quit ) {
+        int cfd = accept(lfd,nullptr,nullptr);
+        if( cfd < 0 ) continue;
+        string buf;
+        char data[4096];
+        for( ssize_t n; !quit and (n = read(cfd,data,sizeof(data))) > 0; ) {
+            buf.append(data,n);
+            for( size_t pos; !quit and (pos = buf.find('\n')) != string::npos; ) {
+                istringstream is(buf.substr(0,pos));
+                buf.erase(0,pos+1);
+                if( is.str().empty() ) continue;
+                auto answer = respond(manager,Jsonz::fromJsonStream(is),quit).toJson() + "\n";
+                for( size_t off = 0; off < answer.size(); ) {
+                    auto w = write(cfd,answer.data()+off,answer.size()-off);
+                    if( w <= 0 ) break;
+                    off += w;
+                }
+            }
+        }
+        close(cfd);
+    }
+
+    close(lfd);
+    unlink(sock.data());
+    return 0;
+}
+
+#endif
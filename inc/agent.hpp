@@ -3,21 +3,145 @@
 
 #include "chainz.hpp"
 #include "token.hpp"
+#include <type_traits>
+#include <atomic>
 
 namespace alioth {
 template<typename T> class agent;
+class arena;
 
+/**
+ * @enum cthing : category of thing --- 事物类别
+ * @desc :
+ *  为每一种由agent管理的具体类型分配一个类别标签
+ *  类别按照继承关系的先序排列,所以任何类型的派生类型都占据一段连续的区间
+ *  判断对象是否属于某类型只需判断其类别是否落在区间之内,不需要运行时类型信息
+ */
+enum class cthing : unsigned char {
+    unknown,
+    thing,
+    node,
+        definition,
+            ClassDef,
+                module,
+            EnumDef,
+            AttrDef,
+            MethodDef,
+            OperatorDef,
+        implementation,
+            MethodImpl,
+            OperatorImpl,
+            ConstructorImpl,
+            InsBlockImpl,
+            ConstructImpl,
+            ExpressionImpl,
+            FlowCtrlImpl,
+            BranchImpl,
+            LoopImpl,
+        depdesc,
+        ModuleSignature,
+        ModuleGranule,
+    eproto,
+    imm,
+    modesc,
+    nameuc,
+    tcp,
+    typeuc,
+    arena,
+};
+
+/**
+ * @struct tagof : 类别区间
+ * @desc :
+ *  描述某类型及其所有派生类型所占据的类别区间
+ *  未登记的类型没有区间,agent对其使用dynamic_cast
+ */
+template<typename T> struct tagof { static constexpr bool tagged = false; };
+template<cthing F, cthing L = F> struct tagrange {
+    static constexpr bool tagged = true;
+    static constexpr bool covers( cthing c ) {return c >= F and c <= L;}
+};
+
+struct node;struct definition;struct implementation;
+struct ClassDef;struct module;struct EnumDef;struct AttrDef;struct MethodDef;struct OperatorDef;
+struct MethodImpl;struct OperatorImpl;struct ConstructorImpl;struct InsBlockImpl;struct ConstructImpl;
+struct ExpressionImpl;struct FlowCtrlImpl;class BranchImpl;class LoopImpl;
+struct depdesc;struct ModuleSignature;struct ModuleGranule;
+struct eproto;struct imm;class modesc;class nameuc;struct tcp;class typeuc;
+
+template<> struct tagof<node> : tagrange<cthing::node,cthing::ModuleGranule> {};
+template<> struct tagof<definition> : tagrange<cthing::definition,cthing::OperatorDef> {};
+template<> struct tagof<ClassDef> : tagrange<cthing::ClassDef,cthing::module> {};
+template<> struct tagof<module> : tagrange<cthing::module> {};
+template<> struct tagof<EnumDef> : tagrange<cthing::EnumDef> {};
+template<> struct tagof<AttrDef> : tagrange<cthing::AttrDef> {};
+template<> struct tagof<MethodDef> : tagrange<cthing::MethodDef> {};
+template<> struct tagof<OperatorDef> : tagrange<cthing::OperatorDef> {};
+template<> struct tagof<implementation> : tagrange<cthing::implementation,cthing::LoopImpl> {};
+template<> struct tagof<MethodImpl> : tagrange<cthing::MethodImpl> {};
+template<> struct tagof<OperatorImpl> : tagrange<cthing::OperatorImpl> {};
+template<> struct tagof<ConstructorImpl> : tagrange<cthing::ConstructorImpl> {};
+template<> struct tagof<InsBlockImpl> : tagrange<cthing::InsBlockImpl> {};
+template<> struct tagof<ConstructImpl> : tagrange<cthing::ConstructImpl> {};
+template<> struct tagof<ExpressionImpl> : tagrange<cthing::ExpressionImpl> {};
+template<> struct tagof<FlowCtrlImpl> : tagrange<cthing::FlowCtrlImpl> {};
+template<> struct tagof<BranchImpl> : tagrange<cthing::BranchImpl> {};
+template<> struct tagof<LoopImpl> : tagrange<cthing::LoopImpl> {};
+template<> struct tagof<depdesc> : tagrange<cthing::depdesc> {};
+template<> struct tagof<ModuleSignature> : tagrange<cthing::ModuleSignature> {};
+template<> struct tagof<ModuleGranule> : tagrange<cthing::ModuleGranule> {};
+template<> struct tagof<eproto> : tagrange<cthing::eproto> {};
+template<> struct tagof<imm> : tagrange<cthing::imm> {};
+template<> struct tagof<modesc> : tagrange<cthing::modesc> {};
+template<> struct tagof<nameuc> : tagrange<cthing::nameuc> {};
+template<> struct tagof<tcp> : tagrange<cthing::tcp> {};
+template<> struct tagof<typeuc> : tagrange<cthing::typeuc> {};
+template<> struct tagof<arena> : tagrange<cthing::arena> {};
+
+/**
+ * @class thing : 事物
+ * @desc :
+ *  所有由agent管理的对象的基类
+ *  若构造时当前线程上有生效的内存场,对象从内存场中分配,成为驻留对象
+ *  驻留对象的引用计数为负,agent不对其计数,也不会删除它,它随内存场一起释放
+ *  引用计数是原子的,模块描述符等对象在并行构建时被多个线程的agent同时引用
+ *  对象的类别由具体类型的构造函数传入,构造之后不再改变,所以查询类别不需要同步
+ */
 class thing {
     public:     token   phrase;
-    protected:  int ref_count;
+    protected:  std::atomic<int> ref_count;
+    private:    const cthing mcategory;
+    protected:
         virtual ~thing() {}
+
+        /**
+         * @constructor thing : 构造函数
+         * @desc :
+         *  登记在cthing中的具体类型通过此构造函数传入自己的类别
+         *  拷贝和移动构造时,类别随对象一起复制
+         * @param c : 类别
+         */
+        explicit thing( cthing c );
     public: 
-        thing():ref_count(0){}
-        thing( const thing& ) = default;
-        thing(thing&&) = default;
-        thing& operator = ( const thing& ) = default;
-        thing& operator = ( thing&& ) = default;
+        thing();
+        thing( const thing& an );
+        thing( thing&& an );
+        thing& operator = ( const thing& an ) {phrase = an.phrase;return *this;}
+        thing& operator = ( thing&& an ) {phrase = std::move(an.phrase);return *this;}
+
+        static void* operator new( size_t size );
+        static void operator delete( void* p );
+
+        /**
+         * @method category : 获取类别
+         * @desc :
+         *  返回对象实际类型的类别
+         */
+        cthing category()const {return mcategory;}
+
+        bool resident()const {return ref_count < 0;}
         template<typename T>friend class agent;
+        friend class arena;
 };
 
 template<typename T>
@@ -28,14 +152,11 @@ class agent {
 
         thing* get(thing* stp)const {
             if( !stp ) return nullptr;
-            stp->ref_count += 1;
+            if( stp->ref_count >= 0 ) stp->ref_count.fetch_add(1,std::memory_order_relaxed);
             return stp;
         }
         void fre(thing* tp)const {
-            if( tp ) {
-                tp->ref_count -= 1;
-                if( tp->ref_count <= 0 ) delete tp;
-            }
+            if( tp and tp->ref_count >= 0 and tp->ref_count.fetch_sub(1,std::memory_order_acq_rel) <= 1 ) delete tp;
         }
     public:
         agent( thing* t = nullptr):p(get(t)) {
@@ -84,10 +205,21 @@ class agent {
         }
 
         T* operator->()const {
-            return dynamic_cast<T*>(p);
+            return cast(p);
         }
         operator T*()const {
-            return dynamic_cast<T*>(p);
+            return cast(p);
+        }
+
+        /**
+         * @method cast : 向下转型
+         * @desc :
+         *  登记了类别区间的类型通过比较类别完成转型,其余类型使用dynamic_cast
+         */
+        static T* cast( thing* t ) {
+            if constexpr( std::is_same<T,thing>::value ) return t;
+            else if constexpr( tagof<T>::tagged ) return t and tagof<T>::covers(t->category()) ? static_cast<T*>(t) : nullptr;
+            else return dynamic_cast<T*>(t);
         }
 };
 
@@ -12,6 +12,10 @@
  */
 
 #include "chainz.hpp"
+#include "flatz.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
 #include <tuple>
 
 namespace alioth {
@@ -32,6 +36,42 @@ namespace alioth {
  */
 inline bool null( const void* p ) { return p == nullptr; }
 
+/**
+ * @function digest : 计算摘要
+ * @desc :
+ *  使用FNV-1a算法计算数据的64位摘要
+ *  摘要被用于判断源文档和模块接口是否发生了变化,不用于任何安全相关的用途
+ *  通过seed参数,可以将多段数据连续地累积到同一个摘要中
+ * @param data : 数据
+ * @param size : 数据长度
+ * @param seed : 初始值,通常是前一段数据的摘要
+ * @return uint64_t : 摘要
+ */
+inline uint64_t digest( const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL ) {
+    auto p = (const unsigned char*)data;
+    for( size_t i = 0; i < size; i++ ) {
+        seed ^= p[i];
+        seed *= 0x100000001b3ULL;
+    }
+    return seed;
+}
+inline uint64_t digest( std::string_view data, uint64_t seed = 0xcbf29ce484222325ULL ) {
+    return digest( "", 1, digest( data.data(), data.size(), seed ) );
+}
+
+/**
+ * @function hexdigest : 摘要的文本形式
+ * @desc :
+ *  将摘要转换为16位十六进制文本,以便写入json文档
+ * @param d : 摘要
+ * @return std::string : 十六进制文本
+ */
+inline std::string hexdigest( uint64_t d ) {
+    std::string ret(16,'0');
+    for( int i = 15; i >= 0; i--, d >>= 4 ) ret[i] = "0123456789abcdef"[d&0xF];
+    return ret;
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+#ifndef __arena__
+#define __arena__
+
+#include "agent.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace alioth {
+
+class arena;
+using $arena = agent<arena>;
+
+/**
+ * @class arena : 内存场
+ * @desc :
+ *  内存场以分块的方式线性地分配内存,分配只需移动块内的指针
+ *  在某线程上启用内存场后,此线程上构造的所有thing对象都从内存场中分配,成为驻留对象
+ *  驻留对象不参与引用计数,指向驻留对象的agent是不持有所有权的句柄
+ *  内存场释放时,按照构造的逆序依次析构所有驻留对象,然后一次性归还所有内存块
+ *  驻留对象之间的引用不会引发级联的析构,所以释放再深的语法树也不会耗尽栈空间
+ *  内存场可以保留其他内存场,当驻留对象被其他内存场中的对象复用时,被复用的内存场不能先于复用者释放
+ *  内存场本身在堆上分配,由agent管理其生命周期,同一个内存场只能被一个线程使用
+ */
+class arena : public thing {
+
+    public:
+
+        /**
+         * @class scope : 启用范围
+         * @desc :
+         *  启用范围在构造时使内存场在当前线程上生效,在析构时恢复之前生效的内存场
+         */
+        class scope {
+            private:
+                arena*  mprev;
+
+            public:
+                scope( arena* a );
+                scope( const scope& ) = delete;
+                scope& operator=( const scope& ) = delete;
+                ~scope();
+        };
+
+    private:
+
+        /**
+         * @struct block : 内存块
+         * @desc :
+         *  内存块的头部之后紧跟可分配的内存
+         */
+        struct block {
+            block*  next;       //前一个分配的内存块
+            size_t  size;       //可分配内存的总量
+            size_t  used;       //已经分配的内存总量
+        };
+
+        /**
+         * @member mblocks : 内存块链表
+         * @desc :
+         *  最新分配的内存块位于链表头部,分配总是在头部的内存块中进行
+         */
+        block* mblocks;
+
+        /**
+         * @member mbytes : 已分配的字节数
+         */
+        size_t mbytes;
+
+        /**
+         * @member mthings : 驻留对象
+         * @desc :
+         *  按照构造的顺序记录所有驻留对象,用于在释放时析构
+         */
+        std::vector<thing*> mthings;
+
+        /**
+         * @member mpending : 待构造的对象
+         * @desc :
+         *  已经分配内存,但尚未开始构造的对象
+         *  构造参数中的new表达式会在外层对象构造之前完成,所以待构造对象总是以栈的顺序被认领
+         */
+        std::vector<void*> mpending;
+
+        /**
+         * @member mretains : 保留的内存场
+         */
+        chainz<$arena> mretains;
+
+        /**
+         * @member mdepth : 保留深度
+         * @desc :
+         *  内存场经由保留关系能够到达的最长链条的长度,不保留其他内存场时为1
+         */
+        size_t mdepth;
+
+    public:
+
+        arena();
+        arena( const arena& ) = delete;
+        arena& operator=( const arena& ) = delete;
+        ~arena();
+
+        /**
+         * @method current : 获取当前内存场
+         * @desc :
+         *  获取在当前线程上生效的内存场
+         * @return arena* : 当前内存场,若没有生效的内存场,返回空
+         */
+        static arena* current();
+
+        /**
+         * @method allocate : 分配内存
+         * @desc :
+         *  从内存场中分配按照最大基础类型对齐的内存
+         * @param size : 字节数
+         * @return void* : 内存地址
+         */
+        void* allocate( size_t size );
+
+        /**
+         * @method retain : 保留内存场
+         * @desc :
+         *  保证另一个内存场在此内存场释放之前不会被释放
+         * @param an : 被保留的内存场
+         */
+        void retain( $arena an );
+
+        /**
+         * @method depth : 获取保留深度
+         */
+        size_t depth()const;
+
+        /**
+         * @method size : 获取已分配的字节数
+         */
+        size_t size()const;
+
+        /**
+         * @method count : 获取驻留对象的个数
+         */
+        size_t count()const;
+
+    private:
+
+        /**
+         * @method claim : 认领对象
+         * @desc :
+         *  thing对象在构造时尝试认领自己,若对象的内存来自此内存场,则成为驻留对象
+         * @param t : 正在构造的对象
+         * @return bool : 对象是否成为驻留对象
+         */
+        bool claim( thing* t );
+
+        /**
+         * @method discard : 放弃分配
+         * @desc :
+         *  对象构造失败时,放弃为其分配的内存
+         * @param p : 内存地址
+         * @return bool : 内存是否来自此内存场
+         */
+        bool discard( void* p );
+
+        /**
+         * @method release : 释放内存场
+         * @desc :
+         *  按照构造的逆序析构所有驻留对象,然后归还所有内存块
+         */
+        void release();
+
+        friend class thing;
+};
+
+}
+
+#endif
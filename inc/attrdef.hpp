@@ -36,6 +36,7 @@ struct AttrDef : public definition {
 
     public:
 
+        AttrDef();
         bool is( cnode ) const override;
     
 };
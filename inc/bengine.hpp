@@ -0,0 +1,51 @@
+#ifndef __bengine__
+#define __bengine__
+
+#include "dengine.hpp"
+#include "pengine.hpp"
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/IR/Module.h>
+
+namespace alioth {
+using namespace std;
+using namespace llvm;
+
+/**
+ * @class Bengine : 后端引擎
+ * @desc :
+ *  Backend Engine --- 后端引擎
+ *  后端引擎负责将语义引擎产出的翻译单元翻译为目标文件
+ *  目标机器不能在线程之间共享,并行构建时,每个工作线程的语义引擎持有自己的目标机器
+ */
+class Bengine {
+
+    public:
+        /**
+         * @method createTargetMachine : 创建目标机器
+         * @desc :
+         *  为本机平台创建目标机器,目标机器不能在线程之间共享
+         *  调用此方法之前,目标平台必须已经被初始化
+         * @param triple : 目标平台描述
+         * @return TargetMachine* : 目标机器,若失败返回nullptr
+         */
+        static TargetMachine* createTargetMachine( const string& triple );
+
+        /**
+         * @method translate : 翻译
+         * @desc :
+         *  使用指定的目标机器,将翻译单元翻译为目标文件
+         *  目标文件首先在内存中产生,随后写入文件,以便下一次构建时复用
+         * @param unit : 翻译单元,其目标平台和数据布局已经被设置
+         * @param machine : 目标机器
+         * @param fd : 目标文件描述符
+         * @param dengine : 文档引擎
+         * @param image : 若指定此参数,目标文件的内容被保留在此对象中
+         * @param pengine : 性能引擎,若正在追踪,则为每个llvm遍产生追踪事件
+         * @return bool : 是否成功
+         */
+        static bool translate( Module& unit, TargetMachine& machine, Dengine::vfdm fd, Dengine& dengine, string* image = nullptr, Pengine* pengine = nullptr );
+};
+
+}
+
+#endif
@@ -17,7 +17,7 @@ class BranchImpl : public implementation {
         $implementation      secnd;
 
     public:
-        BranchImpl() = default;
+        BranchImpl();
         ~BranchImpl() = default;
 
         BranchImpl( const BranchImpl& ) = delete;
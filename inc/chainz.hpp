@@ -7,6 +7,7 @@
  * 
  * 修正了remove方法传入负数,反向寻址时抛出溢出异常的bug
  * 修正了迭代器后缀自变运算依然提前变化的bug
+ * 指针表的容量与元素总量分开记录,容量按倍数增长,插入与删除不再每次重建指针表
  * 
  * 
  * chainz使用指针池结构存储数据
@@ -149,13 +150,52 @@ class chainz {
         
         R*      m_pool;     //元素指针列表
         int     m_count;    //元素总量统计
+        int     m_cap;      //指针列表的容量
+
+        /**
+         * @param need: 需要容纳的元素总量
+         * @state: 确保指针列表至少能容纳need个元素指针
+         * ---- 容量不足时,容量按倍数增长,使得连续插入的均摊开销为常数
+         */
+        void grow( IN int need ) {
+            if( need <= m_cap ) return;
+            int cap = m_cap < 4 ? 4 : m_cap * 2;
+            if( cap < need ) cap = need;
+            R* nr = new R[cap];
+            if( m_count ) memcpy( nr, m_pool, m_count*sizeof(R) );
+            delete[] m_pool;
+            m_pool = nr;
+            m_cap = cap;
+        }
+
+        /**
+         * @param index: 正向索引,范围是 [0,size()]
+         * @param pdata: 元素指针
+         * @state: 将元素指针放入指针列表的index位置,其后的指针依次后移
+         */
+        void place( IN int index, IN R pdata ) {
+            grow( m_count + 1 );
+            if( index < m_count ) memmove( m_pool+index+1, m_pool+index, (m_count-index)*sizeof(R) );
+            m_pool[index] = pdata;
+            m_count += 1;
+        }
+
+        /**
+         * @param index: 正向索引,范围是 [0,size())
+         * @state: 将index位置的指针从指针列表中移出,其后的指针依次前移
+         * ---- 指针所指的元素不被删除,指针列表的容量不变
+         */
+        void displace( IN int index ) {
+            memmove( m_pool+index, m_pool+index+1, (m_count-index-1)*sizeof(R) );
+            m_count -= 1;
+        }
     
     public:
         /**
          * @state: 构造函数
          */
         chainz():
-        m_pool(nullptr),m_count(0) {
+        m_pool(nullptr),m_count(0),m_cap(0) {
 
         }
 
@@ -164,7 +204,8 @@ class chainz {
          * @state: 拷贝构造函数,从另一个实例按照原顺序拷贝每一个元素
          */
         chainz( const chainz& another ):
-        m_pool(nullptr),m_count(0) {
+        m_pool(nullptr),m_count(0),m_cap(0) {
+            grow( another.m_count );
             for( int i = 0; i < another.m_count; i++ )
                 push( another[i] );
         }
@@ -174,9 +215,10 @@ class chainz {
          * @state: 移动构造函数,从右值实例中抓取系统资源
          */
         chainz( chainz&& temp ):
-        m_pool(temp.m_pool),m_count(temp.m_count) {
+        m_pool(temp.m_pool),m_count(temp.m_count),m_cap(temp.m_cap) {
             temp.m_pool = nullptr;
             temp.m_count = 0;
+            temp.m_cap = 0;
         }
 
         /**
@@ -218,8 +260,10 @@ class chainz {
             clear();
             m_pool = tempz.m_pool;
             m_count = tempz.m_count;
+            m_cap = tempz.m_cap;
             tempz.m_count = 0;
             tempz.m_pool = nullptr;
+            tempz.m_cap = 0;
             return *this;
         }
 
@@ -231,6 +275,28 @@ class chainz {
             return m_count;
         }
 
+        /**
+         * @return: 指针列表的容量
+         * @state: 在不重新分配指针列表的前提下,容器能容纳的元素总量
+         */
+        int capacity()const{
+            return m_cap;
+        }
+
+        /**
+         * @param count: 预期的元素总量
+         * @state: 预先分配指针列表,用于已知元素总量的批量插入
+         */
+        void reserve( IN int count ) {
+            if( count > m_cap ) {
+                R* nr = new R[count];
+                if( m_count ) memcpy( nr, m_pool, m_count*sizeof(R) );
+                delete[] m_pool;
+                m_pool = nr;
+                m_cap = count;
+            }
+        }
+
         /**
          * @param data: 插入数据的实例
          * @param index: 数据插入后,所在的位置
@@ -247,72 +313,28 @@ class chainz {
         }
         bool insert( IN T&& data, IN int index ) {
 
-            //若表为空,则情况单独处理
-            if( m_count == 0 ) {
-                if( index == 0 or index == -1 ) {
-                    m_pool = new R[1];
-                    m_pool[0] = new T(std::move(data));
-                } else {
-                    return false;
-                }
-            
-            //若表不为空
-            } else {
-                //若索引小于0,则先修正索引到正向
-                if( index < 0 )
-                    index = m_count + 1 + index;
-                //若正向索引超出范围,则返回失败
-                if( index > m_count or index < 0 )
-                    return false;
-                
-                //创建新表,将原表中的元素指针映射到新表中,同时插入新的元素的指针
-                R* nr = new R[m_count+1];
-                memcpy( nr, m_pool, index*sizeof(R) );
-                nr[index] = new T(std::move(data));
-                memcpy( nr+index+1, m_pool+index, (m_count-index)*sizeof(R));
-
-                //删除原表,替换表指针
-                delete[] m_pool;
-                m_pool = nr;
-            }
+            //若索引小于0,则先修正索引到正向
+            if( index < 0 )
+                index = m_count + 1 + index;
+            //若正向索引超出范围,则返回失败
+            if( index > m_count or index < 0 )
+                return false;
 
-            //收尾工作
-            m_count += 1;
+            //在指针列表中插入新的元素的指针
+            place( index, new T(std::move(data)) );
             return true;
         }
         bool insert( IN T* pdata, IN int index ) {
 
-            //若表为空,则情况单独处理
-            if( m_count == 0 ) {
-                if( index == 0 or index == -1 ) {
-                    m_pool = new R[1];
-                    m_pool[0] = pdata;
-                } else {
-                    return false;
-                }
-            
-            //若表不为空
-            } else {
-                //若索引小于0,则先修正索引到正向
-                if( index < 0 )
-                    index = m_count + 1 + index;
-                //若正向索引超出范围,则抛出异常
-                if( index > m_count or index < 0 )
-                    return false;
-                
-                //创建新表,将原表中的元素指针映射到新表中,同时插入新的元素的指针
-                R* nr = new R[m_count+1];
-                memcpy( nr, m_pool, index*sizeof(R) );
-                nr[index] = pdata;
-                memcpy( nr+index+1, m_pool+index, (m_count-index)*sizeof(R));
-
-                //删除原表,替换表指针
-                delete[] m_pool;
-                m_pool = nr;
-            }
+            //若索引小于0,则先修正索引到正向
+            if( index < 0 )
+                index = m_count + 1 + index;
+            //若正向索引超出范围,则返回失败
+            if( index > m_count or index < 0 )
+                return false;
 
-            //收尾工作
-            m_count += 1;
+            //在指针列表中插入元素指针
+            place( index, pdata );
             return true;
         }
 
@@ -330,21 +352,8 @@ class chainz {
         T* pickout( int index ) {
             T* t = get(index);
             if( !t ) return nullptr;
-            //若容器只有此元素一个,则执行清空动作
-            if( m_count == 1 ) {
-                delete[] m_pool;
-                m_pool = nullptr;
-                m_count = 0;
-            
-            //否则,应当重新映射指针表到新的表格中
-            } else {
-                R* nr = new R[m_count-1];
-                memcpy( nr, m_pool, index*sizeof(R) );
-                memcpy( nr+index, m_pool+index+1, (m_count-index-1)*sizeof(R) );
-                delete[] m_pool;
-                m_pool = nr;
-                m_count -= 1;
-            }
+            if( index < 0 ) index = m_count + index;
+            displace( index );
             return t;
         }
 
@@ -374,24 +383,9 @@ class chainz {
             if( index >= m_count or index < 0 )
                 return false;
             
-            //删除index对应位置上的元素
+            //删除index对应位置上的元素,并将其指针移出指针列表
             delete m_pool[index];
-
-            //若容器只有此元素一个,则执行清空动作
-            if( m_count == 1 ) {
-                delete[] m_pool;
-                m_pool = nullptr;
-                m_count = 0;
-            
-            //否则,应当重新映射指针表到新的表格中
-            } else {
-                R* nr = new R[m_count-1];
-                memcpy( nr, m_pool, index*sizeof(R) );
-                memcpy( nr+index, m_pool+index+1, (m_count-index-1)*sizeof(R) );
-                delete[] m_pool;
-                m_pool = nr;
-                m_count -= 1;
-            }
+            displace( index );
 
             //收尾
             return true;
@@ -413,18 +407,34 @@ class chainz {
             return false;
         }
 
+        /**
+         * @param func: 筛选函数
+         * @return: 被删除的元素的数量
+         * @state: 删除所有使func返回true的元素
+         * ---- 只遍历一次容器,剩余元素的相对次序不变
+         */
+        int remove_if( IN std::function<bool(const T&data)> func ) {
+            int w = 0;
+            for( int i = 0; i < m_count; i++ ) {
+                if( func( *(m_pool[i]) ) ) delete m_pool[i];
+                else m_pool[w++] = m_pool[i];
+            }
+            int removed = m_count - w;
+            m_count = w;
+            return removed;
+        }
+
         /**
          * @return: 无
          * @state: 清空容器,删除所有内容
          */
         void clear() {
-            if( m_count != 0 ) {
-                for( int i = 0; i < m_count; i++ )
-                    if( m_pool[i] ) delete m_pool[i];
-                delete[] m_pool;
-                m_pool = nullptr;
-                m_count = 0;
-            }
+            for( int i = 0; i < m_count; i++ )
+                if( m_pool[i] ) delete m_pool[i];
+            delete[] m_pool;
+            m_pool = nullptr;
+            m_count = 0;
+            m_cap = 0;
             return;
         }
 
@@ -477,7 +487,7 @@ class chainz {
             return *this;
         }
         chainz& operator<<(IN T&& data ) {
-            inqueue(data);
+            inqueue(std::move(data));
             return *this;
         }
 
@@ -589,51 +599,38 @@ class chainz {
 
         chainz operator+( const chainz& an )const {
             chainz res;
-            int in = 0;
-            res.m_count = an.m_count + m_count;
-            if( res.m_count == 0 ) return std::move(res);
-            res.m_pool = new R[res.m_count];
-            for( const auto& i : *this ) res.m_pool[in++] = new T(i);
-            for( const auto& i : an ) res.m_pool[in++] = new T(i);
+            res.reserve( m_count + an.m_count );
+            for( const auto& i : *this ) res.m_pool[res.m_count++] = new T(i);
+            for( const auto& i : an ) res.m_pool[res.m_count++] = new T(i);
             return std::move(res);
         }
         chainz operator+( chainz&& an )const {
             chainz res;
-            int in = 0;
-            res.m_count = an.m_count + m_count;
-            if( res.m_count == 0 ) return std::move(res);
-            res.m_pool = new R[res.m_count];
-            for( const auto& i : *this ) res.m_pool[in++] = new T(i);
-            memcpy(res.m_pool+in,an.m_pool,an.m_count*sizeof(R));
-            delete an.m_pool;
+            res.reserve( m_count + an.m_count );
+            for( const auto& i : *this ) res.m_pool[res.m_count++] = new T(i);
+            if( an.m_count ) memcpy(res.m_pool+res.m_count,an.m_pool,an.m_count*sizeof(R));
+            res.m_count += an.m_count;
+            delete[] an.m_pool;
             an.m_pool = nullptr;
             an.m_count = 0;
+            an.m_cap = 0;
             return std::move(res);
         }
         chainz& operator+=( const chainz& an ) {
-            int nc = m_count + an.m_count;
-            int in = m_count;
-            if( nc == 0 ) return *this;
-            R* np = new R[nc];
-            memcpy(np,m_pool,m_count*sizeof(R));
-            for( const auto& i : an ) np[in++] = new T(i);
-            delete m_pool;
-            m_pool = np;
-            m_count = nc;
+            if( &an == this ) return *this += chainz(an);
+            grow( m_count + an.m_count );
+            for( const auto& i : an ) m_pool[m_count++] = new T(i);
             return *this;
         }
         chainz& operator+=( chainz&& an ) {
-            int nc = m_count + an.m_count;
-            if( nc == 0 ) return *this;
-            R* np = new R[nc];
-            memcpy(np,m_pool,m_count*sizeof(R));
-            memcpy(np+m_count,an.m_pool,an.m_count*sizeof(R));
-            delete an.m_pool;
+            if( &an == this ) return *this += chainz(an);
+            grow( m_count + an.m_count );
+            if( an.m_count ) memcpy(m_pool+m_count,an.m_pool,an.m_count*sizeof(R));
+            m_count += an.m_count;
+            delete[] an.m_pool;
             an.m_pool = nullptr;
             an.m_count = 0;
-            delete m_pool;
-            m_pool = np;
-            m_count = nc;
+            an.m_cap = 0;
             return *this;
         }
 };
@@ -42,7 +42,7 @@ struct ClassDef : public definition {
          *  在模板用例中,模板参数列表应当被适当填充
          *  在其他类定义中,模板参数列表只是形参
          */
-        chainz<token> tmpls;
+        tokens tmpls;
 
         /**
          * @member targs : 模板参数实参
@@ -107,8 +107,16 @@ struct ClassDef : public definition {
          */
         ClassDefs usages;
 
+    protected:
+        /**
+         * @constructor ClassDef : 构造函数
+         * @desc :
+         *  派生自类定义的具体类型,如模块,通过此构造函数传入自己的类别
+         */
+        explicit ClassDef( cthing c );
+
     public:
-        ClassDef() = default;
+        ClassDef();
         ~ClassDef() = default;
 
         ClassDef( const ClassDef& ) = delete;
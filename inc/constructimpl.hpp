@@ -40,6 +40,7 @@ struct ConstructImpl : public implementation {
         $ExpressionImpl init;
 
     public:
+        ConstructImpl();
         bool is( cnode ) const override;
 
 };
@@ -51,6 +51,7 @@ struct ConstructorImpl : public implementation {
         implementations initiate;
     public:
 
+        ConstructorImpl();
         bool is( cnode ) const override;
 };
 
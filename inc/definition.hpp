@@ -41,9 +41,10 @@ struct definition : public node {
         /**
          * @constructor : 构造函数
          * @desc :
+         *  具体的定义传入自己的类别
          *  提供默认的拷贝构造函数和移动构造函数
          */
-        definition() = default;
+        explicit definition( cthing c ):node(c) {}
         definition( const definition& ) = default;
         definition( definition&& ) = default;
 
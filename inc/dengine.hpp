@@ -8,6 +8,8 @@
 #include <memory>
 #include <iostream>
 #include <functional>
+#include <mutex>
+#include <string_view>
 
 #ifdef __WINDOWS__
 #define dirdvc '\\'
@@ -83,6 +85,54 @@ class Dengine {
         };
         using vfds = chainz<vfd>;
 
+        /**
+         * @class vmap : 文件映像
+         * @desc :
+         *  文件内容在内存中的只读映像,映像在析构时被释放
+         *  默认文档引擎通过mmap将文件映射到内存,不必将文件内容复制到缓冲区
+         *  若设置了自定义的输入流获取器,或文件不能被映射,则文件内容被读入映像持有的缓冲区
+         *  映像只能被移动,不能被复制
+         */
+        class vmap {
+            private:
+                const char*     mdata;      //映像内容的开始
+                size_t          msize;      //映像内容的长度
+                bool            mmapped;    //映像内容是否由mmap映射
+                string          mbuffer;    //未被映射时,持有文件内容的缓冲区
+                bool            mgood;      //文件是否被成功打开
+
+            public:
+                vmap();
+                vmap( const vmap& ) = delete;
+                vmap( vmap&& an );
+                ~vmap();
+                vmap& operator=( const vmap& ) = delete;
+                vmap& operator=( vmap&& an );
+
+                /**
+                 * @method map : 映射文件
+                 * @desc :
+                 *  从文件描述符映射文件内容,文件描述符在映射之后被关闭
+                 * @param fd : 文件描述符
+                 * @return bool : 是否成功
+                 */
+                bool map( int fd );
+
+                /**
+                 * @method load : 加载文件
+                 * @desc :
+                 *  将输入流的全部内容读入映像持有的缓冲区
+                 * @param is : 输入流
+                 * @return bool : 是否成功
+                 */
+                bool load( istream& is );
+
+                bool good()const;
+                const char* data()const;
+                size_t size()const;
+                string_view view()const;
+        };
+
         using IstreamGetter = function<uistream(const string&, vspace,const string&)>;
         using OstreamGetter = function<uostream(const string&, vspace,const string&)>;
         using VfileEnumer   = function<vfds(vspace, const string&, const string&)>;
@@ -104,6 +154,14 @@ class Dengine {
         VfileEnumer     medoc;  //枚举文档名的回调方法
         VfileStater     msdoc;  //查文件信息的回调方法
 
+        /**
+         * @member mcustom : 自定义获取器互斥量
+         * @desc :
+         *  自定义的输入输出流获取器可能通过标准输入输出与调用者交互,不能被多个线程同时调用
+         *  管理器并行分析模块时,所有对自定义获取器的调用都由此互斥量串行化
+         */
+        mutable std::mutex mcustom;
+
     public:
         Dengine();
         Dengine( const Dengine& ) = delete;
@@ -159,6 +217,7 @@ class Dengine {
         vfds        enumFile( vspace, const string& subdir, const string& app = "" )const;
         bool        statFile( const string& fname, vspace, const string& app, vfd& )const;
         string      getPath(const string&, vspace, const string& app = "" )const;
+        vmap        mapFile( const string&, vspace, const string& app = "" )const;
         
         uistream    getIs( const vfdm& fdm )const;
         int         getIfd( const vfdm& fdm )const;
@@ -166,6 +225,7 @@ class Dengine {
         int         getOfd( const vfdm& fdm )const;
         vfds        enumFile( const vfdm& fdm )const;
         string      getPath(const vfdm& fdm )const;
+        vmap        mapFile( const vfdm& fdm )const;
 
         /**
          * @method setSpacePath : 对默认文档引擎进行基础设置
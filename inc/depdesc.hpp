@@ -67,7 +67,7 @@ struct depdesc : public node {
         token   mfrom;
 
     public:
-        depdesc() = default;
+        depdesc();
         depdesc( const depdesc& ) = default;
         depdesc( depdesc&& ) = default;
         ~depdesc() = default;
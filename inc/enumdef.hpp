@@ -11,6 +11,7 @@ struct EnumDef : public definition {
         tokens items;
 
     public:
+        EnumDef();
         bool is( cnode ) const override;
         
 };
@@ -68,7 +68,7 @@ struct eproto : public thing {
          */
         eproto( const eproto& ) = default;
         eproto( eproto&& ) = default;
-        eproto() = default;
+        eproto();
         ~eproto() = default;
 
         /**
@@ -95,6 +95,7 @@ struct ExpressionImpl : public implementation {
         $eproto  target;         //  mtype 为treat，convert时有效
 
     public:
+        ExpressionImpl();
         bool is( cnode ) const override;
         
 };
@@ -0,0 +1,475 @@
+#ifndef __flatz__
+#define __flatz__
+
+/**
+ * flatz是chainz的连续存储版本
+ *
+ * chainz为每个元素单独分配内存,元素地址稳定,但内存碎片化严重,每次访问都需要一次指针跳转
+ * flatz将所有元素直接存放在一块连续的缓冲区中,适用于体积小,可以廉价移动的值类型
+ *
+ * flatz提供与chainz一致的接口
+ * flatz支持基于范围的迭代,迭代器同样以容器引用和位置表示
+ * flatz能反向寻址(即 ele[-1] 表示ele的倒数第一个元素这样的寻址)
+ * flatz的缓冲区容量按倍数增长,尾部插入与删除的均摊开销为常数
+ *
+ * 与chainz不同,flatz不保证元素地址稳定
+ * 插入元素可能使得此前获取的元素引用和指针失效,但迭代器依然有效
+ * 因此flatz不提供以指针交接元素所有权的insert(T*)和pickout方法
+ *
+ */
+
+#include "chainz.hpp"
+#include <functional>
+#include <cstring>
+#include <iterator>
+#include <new>
+
+template<typename T>
+class flatz {
+
+    protected:
+        /**
+         * 迭代器与chainz的迭代器保持一致,只记录容器引用和位置
+         * ---- aC表示flatz的引用的类型
+         * ---- aT则表示flatz的内容的类型
+         */
+        template<typename aC,typename aT>
+        struct b_iterator {
+
+            public:
+
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = aT;
+                using difference_type = int;
+                using pointer = aT*;
+                using reference = aT&;
+
+                aC& r;      //迭代器所对应的容器引用
+                int pos;    //迭代器当前所指示的位置
+
+            public:
+                b_iterator( aC& _r, int p ):r(_r),pos(p){}
+                b_iterator( const b_iterator& i ):r(i.r),pos(i.pos){}
+                ~b_iterator(){}
+
+                b_iterator& operator++(){pos += 1;return *this;}
+                b_iterator operator++(int){b_iterator an = *this;pos += 1;return an;}
+                b_iterator& operator--(){pos -= 1;return *this;}
+                b_iterator operator--(int){b_iterator an = *this;pos -= 1;return an;}
+                b_iterator operator+( int a ){return b_iterator( r, pos+a );}
+                b_iterator operator-( int s ){return b_iterator( r, pos-s );}
+                b_iterator& operator+=( int a ){pos+=a;return *this;}
+                b_iterator& operator-=( int s ){pos-=s;return *this;}
+
+                aT& operator*(){return r[pos];}
+                aT* operator->(){return r.get(pos);}
+
+                bool operator==( const b_iterator& an ){ return &r == &an.r and pos == an.pos;}
+                bool operator!=( const b_iterator& an ){ return !(*this==an);}
+        };
+    public:
+        using iterator = b_iterator<flatz,T>;
+        using citerator = b_iterator<const flatz,const T>;
+
+    protected:
+
+        T*      m_data;     //元素缓冲区
+        int     m_count;    //元素总量统计
+        int     m_cap;      //缓冲区容量
+
+        /**
+         * @param cap: 新的容量
+         * @state: 重新分配缓冲区,将原有元素移动到新的缓冲区中
+         */
+        void realloc( IN int cap ) {
+            T* nd = static_cast<T*>(::operator new( cap*sizeof(T) ));
+            for( int i = 0; i < m_count; i++ ) {
+                new(nd+i) T(std::move(m_data[i]));
+                m_data[i].~T();
+            }
+            ::operator delete( m_data );
+            m_data = nd;
+            m_cap = cap;
+        }
+
+        /**
+         * @param need: 需要容纳的元素总量
+         * @state: 确保缓冲区至少能容纳need个元素,容量不足时按倍数增长
+         */
+        void grow( IN int need ) {
+            if( need <= m_cap ) return;
+            int cap = m_cap < 4 ? 4 : m_cap * 2;
+            realloc( cap < need ? need : cap );
+        }
+
+        /**
+         * @param index: 正向索引,范围是 [0,size()]
+         * @param data: 元素实例
+         * @return: 插入后,元素的引用
+         * @state: 将元素移动到index位置,其后的元素依次后移
+         * ---- data不能引用容器内的元素,调用者应当先行拷贝
+         */
+        T& place( IN int index, IN T&& data ) {
+            grow( m_count + 1 );
+            if( index == m_count ) {
+                new(m_data+m_count) T(std::move(data));
+            } else {
+                new(m_data+m_count) T(std::move(m_data[m_count-1]));
+                for( int i = m_count-1; i > index; i-- ) m_data[i] = std::move(m_data[i-1]);
+                m_data[index] = std::move(data);
+            }
+            m_count += 1;
+            return m_data[index];
+        }
+
+    public:
+        /**
+         * @state: 构造函数
+         */
+        flatz():
+        m_data(nullptr),m_count(0),m_cap(0) {
+
+        }
+
+        /**
+         * @param another: 另一个flatz实例
+         * @state: 拷贝构造函数,从另一个实例按照原顺序拷贝每一个元素
+         */
+        flatz( const flatz& another ):
+        m_data(nullptr),m_count(0),m_cap(0) {
+            reserve( another.m_count );
+            for( int i = 0; i < another.m_count; i++ )
+                new(m_data+m_count++) T(another.m_data[i]);
+        }
+
+        /**
+         * @param temp: 一个右值实例
+         * @state: 移动构造函数,从右值实例中抓取缓冲区
+         */
+        flatz( flatz&& temp ):
+        m_data(temp.m_data),m_count(temp.m_count),m_cap(temp.m_cap) {
+            temp.m_data = nullptr;
+            temp.m_count = 0;
+            temp.m_cap = 0;
+        }
+
+        /**
+         * @param data : 首个元素
+         * @param args : 参数包
+         */
+        template<typename ...Args>
+        flatz( T&& data, Args&&... args ):flatz() {
+            reserve( 1 + sizeof...(args) );
+            construct(-1,std::forward<T>(data)) , ( construct(-1,std::forward<Args>(args)) , ... );
+        }
+
+        /**
+         * @state: 析构函数
+         */
+        ~flatz() {
+            clear();
+        }
+
+        /**
+         * @param another: 另一个flatz实例
+         * @return: 自身引用
+         * @state: 赋值运算,将另一个flatz实例的快照装入
+         */
+        flatz& operator=( const flatz& another ) {
+            flatz temp = another;
+            *this = std::move(temp);
+            return *this;
+        }
+
+        /**
+         * @param temp: 一个右值实例
+         * @return: 自身引用
+         * @state: 赋值运算,从右值实例中移动数据
+         */
+        flatz& operator=( flatz&& temp ) {
+            flatz tempz = std::move(temp);
+            clear();
+            m_data = tempz.m_data;
+            m_count = tempz.m_count;
+            m_cap = tempz.m_cap;
+            tempz.m_data = nullptr;
+            tempz.m_count = 0;
+            tempz.m_cap = 0;
+            return *this;
+        }
+
+        /**
+         * @return: 容器内容单位总量
+         */
+        int size()const{
+            return m_count;
+        }
+
+        /**
+         * @return: 缓冲区的容量
+         */
+        int capacity()const{
+            return m_cap;
+        }
+
+        /**
+         * @param count: 预期的元素总量
+         * @state: 预先分配缓冲区,用于已知元素总量的批量插入
+         */
+        void reserve( IN int count ) {
+            if( count > m_cap ) realloc( count );
+        }
+
+        /**
+         * @param data: 插入数据的实例
+         * @param index: 数据插入后,所在的位置
+         * @return: 插入是否成功
+         * @state: 插入方法,索引规则与chainz::insert相同
+         */
+        bool insert( IN const T& data, IN int index ) {
+            T dat(data);
+            return insert(std::move(dat),index);
+        }
+        bool insert( IN T&& data, IN int index ) {
+            if( index < 0 )
+                index = m_count + 1 + index;
+            if( index > m_count or index < 0 )
+                return false;
+            T dat(std::move(data));     //data可能引用容器内的元素,移动之前先行取出
+            place( index, std::move(dat) );
+            return true;
+        }
+
+        /**
+         * @param index: 创建实例的插入点
+         * @param args: 对象实例的构造函数的参数
+         * @return: 新实例的引用,若插入点超出范围,返回的引用取址为nullptr
+         */
+        template<typename ...Args>
+        T& construct( IN int index, Args&&... args ){
+            if( index < 0 )
+                index = m_count + 1 + index;
+            if( index > m_count or index < 0 )
+                return *(T*)0x0;
+            return place( index, T(std::forward<Args>(args)...) );
+        }
+
+        /**
+         * @param index: 欲删除元素的位置
+         * @return: 删除是否成功
+         * @state: 删除index位置上的元素,其后的元素依次前移
+         */
+        bool remove( IN int index ) {
+            if( index < 0 )
+                index = m_count + index;
+            if( index >= m_count or index < 0 )
+                return false;
+            for( int i = index; i < m_count-1; i++ ) m_data[i] = std::move(m_data[i+1]);
+            m_data[m_count-1].~T();
+            m_count -= 1;
+            return true;
+        }
+
+        /**
+         * @param index: 欲删除的第一个元素的位置
+         * @param count: 欲删除元素的数量
+         * @return: 删除是否成功
+         * @state: 删除从index位置开始的count个元素,其后的元素只前移一次
+         */
+        bool remove( IN int index, IN int count ) {
+            if( index < 0 )
+                index = m_count + index;
+            if( count < 0 or index < 0 or index + count > m_count )
+                return false;
+            for( int i = index; i < m_count-count; i++ ) m_data[i] = std::move(m_data[i+count]);
+            for( int i = m_count-count; i < m_count; i++ ) m_data[i].~T();
+            m_count -= count;
+            return true;
+        }
+
+        /**
+         * @param ref: 数据实例
+         * @return: 删除是否成功
+         * @state: 若ref实例在容器内,则删除ref实例
+         */
+        bool remover( IN const T& ref ) {
+            int i = index( ref );
+            return i >= 0 and remove(i);
+        }
+
+        /**
+         * @param func: 筛选函数
+         * @return: 被删除的元素的数量
+         * @state: 删除所有使func返回true的元素
+         * ---- 只遍历一次容器,剩余元素被依次向前移动,相对次序不变
+         */
+        int remove_if( IN std::function<bool(const T&data)> func ) {
+            int w = 0;
+            for( int i = 0; i < m_count; i++ ) {
+                if( func( m_data[i] ) ) continue;
+                if( w != i ) m_data[w] = std::move(m_data[i]);
+                w += 1;
+            }
+            for( int i = w; i < m_count; i++ ) m_data[i].~T();
+            int removed = m_count - w;
+            m_count = w;
+            return removed;
+        }
+
+        /**
+         * @state: 清空容器,删除所有内容并释放缓冲区
+         */
+        void clear() {
+            for( int i = 0; i < m_count; i++ ) m_data[i].~T();
+            ::operator delete( m_data );
+            m_data = nullptr;
+            m_count = 0;
+            m_cap = 0;
+            return;
+        }
+
+        /**
+         * @state: 栈与队列操作,语义与chainz相同
+         */
+        bool push( IN const T& data ) {
+            return insert( data, -1 );
+        }
+        bool push( IN T&& data ) {
+            return insert(std::move(data), -1 );
+        }
+        bool pop() {
+            return remove(-1);
+        }
+        bool pop( OUT T& data ){
+            T* p = get(-1);
+            if( p == nullptr )
+                return false;
+            data = std::move(*p);
+            return pop();
+        }
+        bool inqueue( IN const T& data ) {
+            return insert( data, -1 );
+        }
+        bool inqueue( IN T&& data ) {
+            return insert(std::move(data), -1 );
+        }
+        flatz& operator<<( IN const T& data ) {
+            inqueue(data);
+            return *this;
+        }
+        flatz& operator<<(IN T&& data ) {
+            inqueue(std::move(data));
+            return *this;
+        }
+        bool outqueue(){
+            return remove(0);
+        }
+        bool outqueue( OUT T& data ) {
+            T* p = get(0);
+            if( p == nullptr )
+                return false;
+            data = std::move(*p);
+            return outqueue();
+        }
+
+        /**
+         * @param index: 元素的索引
+         * @return: 索引位置上,元素的指针
+         * @state: 获取index位置上的元素的指针
+         * ---- 若index位置上没有数据,则返回空指针
+         */
+        T* get( IN int index ) {
+            if( index < 0 )
+                index = m_count + index;
+            if( index >= m_count or index < 0 )
+                return nullptr;
+            else
+                return m_data+index;
+        }
+        const T* get( IN int index )const {
+            if( index < 0 )
+                index = m_count + index;
+            if( index >= m_count or index < 0 )
+                return nullptr;
+            else
+                return m_data+index;
+        }
+
+        /**
+         * @param index: 元素索引
+         * @return: 索引位置上,元素的引用
+         * ---- 若index位置上没有数据,则返回的引用取址为nullptr
+         */
+        T& operator[]( IN int index ) {
+            return *get(index);
+        }
+        const T& operator[]( IN int index )const {
+            return *get(index);
+        }
+
+        /**
+         * @param ref: 数据实例的引用
+         * @return: ref实例在容器中的位置,若不在容器中,返回-1
+         */
+        int index( IN const T& ref ) const {
+            if( m_count == 0 or &ref < m_data or &ref >= m_data+m_count )
+                return -1;
+            return &ref - m_data;
+        }
+
+        /**
+         * @return: 迭代器
+         */
+        iterator begin(){
+            return iterator(*this, 0);
+        }
+        citerator begin()const{
+            return citerator(*this,0);
+        }
+        iterator end(){
+            return iterator(*this,m_count);
+        }
+        citerator end()const{
+            return citerator(*this,m_count);
+        }
+
+        /**
+         * @param func: 筛选函数
+         * @return: 筛选过的flatz容器
+         */
+        flatz operator%( IN std::function<bool(const T&data)> func )const{
+            flatz fz = flatz();
+            for( int i = 0; i < m_count; i++ )
+                if( func( m_data[i] ) ) fz << m_data[i];
+            return std::move(fz);
+        }
+        flatz map( IN std::function<bool(const T&data)> func )const {
+            return operator%(func);
+        }
+
+        flatz operator+( const flatz& an )const {
+            flatz res = *this;
+            res += an;
+            return std::move(res);
+        }
+        flatz operator+( flatz&& an )const {
+            flatz res = *this;
+            res += std::move(an);
+            return std::move(res);
+        }
+        flatz& operator+=( const flatz& an ) {
+            if( &an == this ) return *this += flatz(an);
+            grow( m_count + an.m_count );
+            for( int i = 0; i < an.m_count; i++ ) new(m_data+m_count++) T(an.m_data[i]);
+            return *this;
+        }
+        flatz& operator+=( flatz&& an ) {
+            if( &an == this ) return *this += flatz(an);
+            grow( m_count + an.m_count );
+            for( int i = 0; i < an.m_count; i++ ) new(m_data+m_count++) T(std::move(an.m_data[i]));
+            an.clear();
+            return *this;
+        }
+};
+
+#endif
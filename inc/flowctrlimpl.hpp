@@ -45,6 +45,7 @@ struct FlowCtrlImpl : public implementation {
         $ExpressionImpl expr;
 
     public:
+        FlowCtrlImpl();
         bool is( cnode ) const override;
         
 };
@@ -76,7 +76,7 @@ struct imm : thing {
         $imm h;
 
     public:
-        imm() = default;
+        imm();
         imm( immt T, Value* V, anything P, $imm H = nullptr );
         imm( const imm& ) = default;
         imm( imm&& ) = default;
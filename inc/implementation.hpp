@@ -7,6 +7,13 @@ namespace alioth {
 
 struct implementation : public node {
 
+    protected:
+        /**
+         * @constructor : 构造函数
+         * @desc :
+         *  具体的实现传入自己的类别
+         */
+        explicit implementation( cthing c ):node(c) {}
 };
 
 using $implementation = agent<implementation>;
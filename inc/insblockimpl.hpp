@@ -11,6 +11,7 @@ struct InsBlockImpl : public implementation {
         implementations impls;
 
     public:
+        InsBlockImpl();
         bool is( cnode ) const override;
         
 };
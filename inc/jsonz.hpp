@@ -13,11 +13,20 @@
  *      json字符串内容中,若出现需要转义的字符串,最多只转义一个字节.
  * 
  * 本库使用Abon2.0语法,所有Abon1.0语法的文档都不能正常解析
+ * 
+ * 关于带索引的abon编码
+ *      toAbon的版本参数取2时,产生带有文件头的随机访问编码,所有整数都按照小端序存储
+ *      文件头为"ABON"和版本号2,共8字节,字符串以32位长度为前缀
+ *      数组和对象以32位主体长度为前缀,主体以元素个数开头,随后是索引
+ *      数组的索引是每个元素的偏移,对象的索引是按键排序的键偏移,键长度和值偏移,偏移都相对于主体的开始
+ *      JsonzView直接在这种编码上查找键和下标,不必解码整个文档
  */
 
 #include "chainz.hpp"
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <functional>
@@ -36,9 +45,78 @@ enum JType {
 
 class Jsonz {
 
+    public:
+        /**
+         * @struct handler : 事件处理器
+         * @desc :
+         *  parse方法不构造文档树,而是在扫描到每个语法成分时调用处理器的对应方法
+         *  处理器的方法返回false时,分析立即终止并报告失败
+         *  字符串和键以视图的形式传递,不含转义序列的字符串直接引用输入缓冲区,不发生复制
+         *  含有转义序列的字符串被解码到临时缓冲区,所以视图只在回调期间有效
+         *  默认的实现忽略所有事件
+         */
+        struct handler {
+            virtual ~handler() = default;
+            virtual bool null() {return true;}
+            virtual bool boolean( bool ) {return true;}
+            virtual bool integer( long long ) {return true;}
+            virtual bool real( double ) {return true;}
+            virtual bool text( std::string_view ) {return true;}
+            virtual bool key( std::string_view ) {return true;}
+            virtual bool openObject() {return true;}
+            virtual bool closeObject() {return true;}
+            virtual bool openArray() {return true;}
+            virtual bool closeArray() {return true;}
+        };
+
     private:
-        JType   mtype;
-        void*   mdata;
+        /**
+         * @struct member : 对象成员
+         * @desc :
+         *  对象的成员按照键的字典序连续地存储,键是字符串类型的值
+         */
+        struct member;
+
+        /**
+         * 值以16字节的标签联合体表示
+         *  布尔值,64位整数和实数直接存储在值内部
+         *  不超过14字节的字符串存储在值内部,更长的字符串存储在堆上
+         *  数组的元素和对象的成员连续地存储在堆上,值不含指向自身的指针,所以存储区可以按字节搬移
+         *  若值首次需要存储区时有生效的json文档,存储区从文档中分配
+         */
+        union {
+            struct {
+                union {
+                    bool        mbool;
+                    long long   mint;
+                    double      mreal;
+                    void*       mheap;      //长字符串,数组元素或对象成员的存储区
+                };
+                uint32_t        msize;      //长字符串的长度,数组元素或对象成员的个数
+            };
+            struct {
+                char            mshort[14]; //短字符串的内容
+                uint8_t         mlength;    //短字符串的长度,或者存储区来源的标记
+                uint8_t         mtype;      //值的类型
+            };
+        };
+
+        std::string_view view()const;                   //获取字符串的内容,若类型不匹配,返回空视图
+        void assign( const char* data, size_t size );   //将值改为字符串
+        void reserve( size_t size );                    //保证容器可以容纳指定个数的元素
+        Jsonz* slot( size_t index );                    //在数组中腾出一个未构造的位置
+        member* locate( std::string_view key )const;    //查找对象中第一个不小于键的成员
+
+        /**
+         * @class writer : 序列化输出
+         * @desc :
+         *  序列化的结果先写入固定大小的缓冲区,缓冲区满时整体交给目标
+         *  目标可以是调用者提供的可增长缓冲区,也可以是输出流
+         */
+        class writer;
+        void json( writer& w )const;                    //向输出写入json文本
+        void binary( writer& w )const;                  //向输出写入abon编码
+        void indexed( abon& out )const;                 //向缓冲区追加带索引的abon编码,不含文件头
     
     public:
         Jsonz(JType type = JNull);
@@ -48,13 +126,29 @@ class Jsonz {
         ~Jsonz();
         void clear();
 
-        static Jsonz fromJsonStream( std::istream&, int* = nullptr );
+        /**
+         * @method parse : 分析json文本
+         * @desc :
+         *  从缓冲区中分析一个json值,将分析过程以事件的形式报告给处理器
+         *  分析过程不使用递归,嵌套深度不受栈空间限制
+         *  值之后的空白被跳过,其后的内容不被分析
+         * @param data : 缓冲区
+         * @param size : 缓冲区长度
+         * @param h : 事件处理器
+         * @param used : 若不为空,用于返回分析停止的位置
+         * @return bool : 分析是否成功
+         */
+        static bool parse( const char* data, size_t size, handler& h, size_t* used = nullptr );
+
+        static Jsonz fromJson( const char* data, size_t size, size_t* used = nullptr ); //在parse之上构造文档树,失败时返回null
+        static Jsonz fromJsonStream( std::istream&, int* = nullptr );                   //从流中截取恰好一个json值并构造文档树
         static Jsonz fromAbonStream( std::istream&, int* = nullptr );
 
         JType tell()const;
         bool is(JType)const;
 
         explicit operator int()const;   //若类型不匹配,返回0
+        explicit operator long long()const;//若类型不匹配,返回0
         explicit operator double()const;//若类型不匹配,返回0
         explicit operator bool()const;  //若类型不匹配,返回false
         operator std::string()const;    //若类型不匹配,返回空字串
@@ -64,9 +158,11 @@ class Jsonz {
         Jsonz& operator=(Jsonz&&);
         Jsonz& operator=(bool);
         Jsonz& operator=(int);
+        Jsonz& operator=(long long);
         Jsonz& operator=(double);
         Jsonz& operator=(const std::string&);
         Jsonz& operator=(const char*);
+        Jsonz& operator=(std::string_view);
 
         bool insert( const Jsonz&, int index = 0 );     //插入一个值,若对象不是数组,则失败,若位置超过范围,用null填充
         bool insert( Jsonz&&, int index = 0 );          //插入一个值,若对象不是数组,则失败,若位置超过范围,用null填充
@@ -86,7 +182,11 @@ class Jsonz {
         bool drop( const std::string& key );
 
         std::string toJson() const;
-        abon toAbon() const;
+        void toJson( std::string& out )const;           //将json文本追加到缓冲区
+        void toJson( std::ostream& os )const;           //将json文本写入流,不构造完整的文本
+        abon toAbon( int version = 1 ) const;
+        void toAbon( abon& out, int version = 1 )const;         //将abon编码追加到缓冲区,版本2产生带索引的编码
+        void toAbon( std::ostream& os, int version = 1 )const;  //将abon编码写入流
 
         template<JType t, typename ...Args>
         bool test(const std::string& key, Args... args)const {
@@ -118,4 +218,131 @@ class Jsonz {
         }
 };
 
+/**
+ * @class JsonzView : abon视图
+ * @desc :
+ *  视图在带索引的abon编码上只读地访问值,不解码整个文档
+ *  查找键和下标只访问容器的索引和目标值所在的字节,配合文件映像使用时,只有被访问的页面被载入内存
+ *  视图不持有缓冲区,缓冲区必须比视图存活得更久
+ *  越界或格式错误的值被视为无效的视图,无效视图的类型为JNull
+ */
+class JsonzView {
+
+    private:
+        const char*     mdata;      //值的标签,无效视图为空
+        const char*     mend;       //值所在区域的结尾
+
+        JsonzView( const char* data, const char* end );
+        const char* body()const;    //容器主体的开始
+        const char* limit()const;   //容器主体的结尾
+
+    public:
+        JsonzView();
+
+        /**
+         * @method fromAbon : 打开带索引的abon编码
+         * @desc :
+         *  检查文件头,返回根值的视图,若文件头不匹配,返回无效视图
+         * @param data : 缓冲区
+         * @param size : 缓冲区长度
+         * @return JsonzView : 根值的视图
+         */
+        static JsonzView fromAbon( const char* data, size_t size );
+        static bool probe( const char* data, size_t size );    //缓冲区是否以带索引的abon文件头开始
+
+        bool good()const;
+        JType tell()const;
+        bool is(JType)const;
+
+        explicit operator int()const;       //若类型不匹配,返回0
+        explicit operator long long()const; //若类型不匹配,返回0
+        explicit operator double()const;    //若类型不匹配,返回0
+        explicit operator bool()const;      //若类型不匹配,返回false
+        operator std::string()const;        //若类型不匹配,返回空字串
+        std::string_view text()const;       //字符串内容的视图,若类型不匹配,返回空视图
+
+        size_t count()const;                            //查容器内容总量,若对象不是容器,返回0
+        size_t count( std::string_view key )const;      //查看对象是否拥有某个键
+        JsonzView at( std::string_view key )const;      //二分查找对象的索引,若键不存在,返回无效视图
+        JsonzView at( int index )const;                 //负数下标从结尾开始计数,若越界,返回无效视图
+
+        int foreach( std::function<bool(const JsonzView&)> )const;
+        int foreach( std::function<bool(std::string_view,const JsonzView&)> )const;
+
+        /**
+         * @method parse : 遍历值
+         * @desc :
+         *  将值以和Jsonz::parse相同的事件序列报告给处理器,遍历过程不使用递归
+         * @param h : 事件处理器
+         * @return bool : 值是否完好且处理器没有终止遍历
+         */
+        bool parse( Jsonz::handler& h )const;
+        Jsonz decode()const;                            //将值解码为文档树,失败时返回null
+};
+
+/**
+ * @class JsonzDocument : json文档
+ * @desc :
+ *  文档以分块的方式为json值提供存储区,分配只需移动块内的指针,所有存储区在文档释放时一次性归还
+ *  在某线程上启用文档后,此线程上的值首次需要存储区时从文档中分配,此后的增长也在文档中进行
+ *  驻留在文档中的存储区不被单独释放,持有这些存储区的值不能比文档存活得更久
+ *  启用文档期间不应修改比文档存活得更久的空值或空容器,否则它们也会驻留在文档中
+ *  文档可以整体移动,移动不改变存储区的地址,但不能在启用期间移动
+ */
+class JsonzDocument {
+
+    public:
+
+        /**
+         * @class scope : 启用范围
+         * @desc :
+         *  启用范围在构造时使文档在当前线程上生效,在析构时恢复之前生效的文档
+         */
+        class scope {
+            private:
+                JsonzDocument*  mprev;
+
+            public:
+                scope( JsonzDocument* doc );
+                scope( const scope& ) = delete;
+                scope& operator=( const scope& ) = delete;
+                ~scope();
+        };
+
+    private:
+
+        /**
+         * @struct block : 存储块
+         * @desc :
+         *  存储块的头部之后紧跟可分配的存储区
+         */
+        struct block {
+            block*  next;       //前一个分配的存储块
+            size_t  size;       //可分配存储区的总量
+            size_t  used;       //已经分配的存储区总量
+        };
+
+        block*  mblocks;        //存储块链表,分配总是在头部的存储块中进行
+        size_t  mbytes;         //已分配的字节数
+        Jsonz   mroot;          //文档的根
+
+    public:
+
+        JsonzDocument();
+        JsonzDocument( const JsonzDocument& ) = delete;
+        JsonzDocument( JsonzDocument&& an );
+        JsonzDocument& operator=( const JsonzDocument& ) = delete;
+        JsonzDocument& operator=( JsonzDocument&& an );
+        ~JsonzDocument();
+
+        static JsonzDocument* current();    //获取在当前线程上生效的文档,若没有,返回空
+        void* allocate( size_t size );      //分配按照8字节对齐的存储区
+        Jsonz& root();                      //文档的根,根在文档释放时被清空
+        const Jsonz& root()const;
+        size_t size()const;                 //已分配的字节数
+
+    private:
+        void release();                     //清空文档的根,然后归还所有存储块
+};
+
 #endif
\ No newline at end of file
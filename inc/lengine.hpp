@@ -19,6 +19,7 @@
  */
 
 #include "jsonz.hpp"
+#include "dengine.hpp"
 #include "token.hpp"
 #include "agent.hpp"
 
@@ -63,6 +64,8 @@ class Lengine {
             E108,
             E109,
             E110,
+            E111,
+            E112,
             // 201 - 300        //来自module解析过程的任何错误
             E201 = 201,
             E202,
@@ -290,10 +293,45 @@ class Lengine {
 
     private:
         map<int,logt>   mrepo;          //日志模板仓库,将日志模板和日志模板号对应起来
+        Dengine::vmap   mcatalogue;     //带索引的日志模板目录的映像
+        JsonzView       mtmpls;         //日志模板目录中的模板表,模板在首次被使用时才被读入仓库
         bool            mecolor = true; //是否启用日志模板中的颜色.
         bool            mepath = true;  //是否启用文件路径
         string          mpath;          //日志文件路径,此值会在翻译日志库时自动变化.
 
+        /**
+         * @method lookup : 查找日志模板
+         * @desc : 若仓库中没有此模板,尝试从日志模板目录中读取,读取时经过和config相同的检查
+         * @param tno : 日志模板号
+         * @return const logt* : 日志模板,若不存在或格式错误,返回空
+         */
+        const logt* lookup( int tno );
+
+        /**
+         * @method validate : 检查日志模板
+         * @desc : 所有读取日志模板的途径都经过此检查,起始位置和终止位置必须符合格式
+         * @param tm : 字段已经齐全的日志模板
+         * @return bool : 日志模板是否可用
+         */
+        static bool validate( const logt& tm );
+
+        /**
+         * @method attach : 追加协助信息
+         * @desc : 协助信息依次由模板号,路径和参数组成,缺少的模板号和路径取0
+         * @param tm : 日志模板
+         * @param item : 协助信息的各项
+         */
+        static void attach( logt& tm, const chainz<int>& item );
+
+        /**
+         * @method decode : 解码日志模板
+         * @desc : 从文档树或abon视图中读取日志模板,字段缺失或类型错误时失败
+         * @param tmpl : 日志模板对象,可以是Jsonz或JsonzView
+         * @param tm : 读取的日志模板
+         * @return bool : 日志模板是否可用
+         */
+        template<typename J> static bool decode( const J& tmpl, logt& tm );
+
     public:
         Lengine() = default;
         Lengine( const Lengine& ) = delete;
@@ -301,6 +339,28 @@ class Lengine {
         ~Lengine() = default;
 
         bool config( const Jsonz& conf );
+
+        /**
+         * @method config : 配置日志引擎
+         * @desc :
+         *  直接从json文本中读取配置,不构造文档树
+         *  配置的格式和语义与接受文档树的重载相同
+         * @param data : json文本
+         * @param size : 文本长度
+         * @return bool : 是否读取到了日志模板表
+         */
+        bool config( const char* data, size_t size );
+
+        /**
+         * @method config : 配置日志引擎
+         * @desc :
+         *  若映像是带索引的abon编码,日志引擎持有映像,只读取配置项和模板表的位置
+         *  日志模板在首次被使用时才从映像中查找并读入仓库,所以启动时只有被访问的页面被载入内存
+         *  否则映像被当作json文本读取
+         * @param catalogue : 配置文件的映像
+         * @return bool : 是否找到了日志模板表
+         */
+        bool config( Dengine::vmap&& catalogue );
         void color( bool );
         void path( bool );
         void path( const string& p);
@@ -316,6 +376,17 @@ class Lengine {
         }
 
         Jsonz operator()( const logr& lr);
+
+        /**
+         * @method operator() : 生成诊断报告
+         * @desc :
+         *  在文档中生成日志仓库的诊断报告,报告的所有存储区都分配在文档中
+         *  报告成为文档的根,随文档一起释放
+         * @param lr : 日志仓库
+         * @param doc : 文档
+         * @return Jsonz& : 文档的根
+         */
+        Jsonz& operator()( const logr& lr, JsonzDocument& doc );
         Jsonz operator()( const logs& ls);
         Jsonz operator()( const logi& li);
 };
@@ -12,7 +12,7 @@ namespace alioth{
             $ExpressionImpl cond;
 
         public:
-            LoopImpl() = default;
+            LoopImpl();
             ~LoopImpl() = default;
 
             LoopImpl( const LoopImpl& ) = delete;
@@ -18,6 +18,9 @@
 #include "dengine.hpp"
 #include "lengine.hpp"
 #include "sengine.hpp"
+#include "pengine.hpp"
+#include "xengine.hpp"
+#include <functional>
 #include <memory>
 #include <list>
 
@@ -48,12 +51,18 @@ class Manager {
 
     private:
         string              appname;        //本次构建的目标应用名称
+        int                 mjobs;          //并行任务数,用于词法语法分析,语义分析和后端翻译
         Lengine             mlengine;       //日志引擎
         Dengine             mdengine;       //文档引擎
-        Sengine             msengine;       //语义引擎
+        Pengine             mpengine;       //性能引擎
+        unique_ptr<Sengine> msengine;       //语义引擎,常驻时在多次构建之间保留已装载的模块定义,否则每次构建时重新创建
         modescs             mwork;          //工作空间中的模块描述符
         modescs             mroot;          //根空间中的模块描述符
         map<string,modescs> mapps;          //各个应用空间的模块描述符
+        bool                mloaded;        //模块描述符表是否已经从文件加载
+        bool                mresident;      //是否常驻,常驻时缓存文档的词法分析结果
+        map<string,tuple<string,tokens,string>> mlexcache;   //词法缓存:文档路径 -> (内容摘要,词法记号序列,文档内容)
+        mutex               mlexmutex;      //保护词法缓存的结构,同一文档不会被并发地分析
 
         /**
          * 下述内容是每次构建时的构建时记录内容
@@ -83,6 +92,26 @@ class Manager {
         bool setAppName( const string& name );
         string getAppName() const;
 
+        /**
+         * @method setJobs : 设置并行任务数
+         * @desc : 模块的各个文档被并行地进行词法分析和语法分析,模块描述符表的签名扫描同样并行执行
+         *      定义语义分析由主语义引擎执行,多个模块需要翻译时,每个工作线程拥有独立的语义引擎和llvm上下文环境
+         *      模块在其依赖完成之后被调度到工作线程,在同一线程中完成实现语义分析和目标文件的产生
+         * @param jobs : 并行任务数,若小于1,则使用处理器核心数
+         */
+        void setJobs( int jobs );
+        int getJobs() const;
+
+        /**
+         * @method parallel : 并行执行
+         * @desc : 使用至多getJobs()个线程执行一组相互独立的任务,所有任务完成后返回
+         *      任务按编号被领取,调用者按编号合并结果,所以合并的顺序是确定的
+         *      并行任务数为1或只有一个任务时,任务在当前线程中依次执行
+         * @param count : 任务数
+         * @param task : 任务,参数为任务编号
+         */
+        void parallel( size_t count, const function<void(size_t)>& task );
+
         /**
          * @method verifyAppName : 验证应用名称
          * @desc : 要构建一个应用
@@ -112,6 +141,42 @@ class Manager {
          */
         Lengine& getLogEngine();
 
+        /**
+         * @method getPerformanceEngine : 获取manager所绑定的性能引擎
+         * @desc : 获取manager所绑定的性能引擎的引用
+         * @return Pengine& : 绑定的性能引擎的引用
+         */
+        Pengine& getPerformanceEngine();
+
+        /**
+         * @method setResident : 设置常驻
+         * @desc : 常驻的管理器在多次构建之间保留模块描述符表和文档的词法分析结果
+         *      模块描述符表只在第一次构建时从文件加载,此后只根据文档的修改时间刷新
+         *      内容没有变化的文档不会被重新进行词法分析
+         *      语义引擎也被保留,只有源码变化的模块及依赖它们的模块被重新装载
+         * @param resident : 是否常驻
+         */
+        void setResident( bool resident );
+
+        /**
+         * @method isResident : 是否常驻
+         * @return bool : 管理器是否常驻
+         */
+        bool isResident()const;
+
+        /**
+         * @method lexDocument : 对文档进行词法分析
+         * @desc : 对源文档内容进行词法分析,常驻时,优先使用词法缓存
+         *      返回的词法记号序列总是一份副本,语法分析可以随意修改它
+         *      返回的词法记号序列不包含空白和注释
+         *      文档内容变化时,只对受修改影响的区域重新进行词法分析
+         * @param path : 文档路径,作为缓存的键,也是文档在源码映射中登记的路径
+         * @param src : 文档内容,通常是文档引擎产生的文件映像
+         * @param change : 若不为空,用于接收相对于缓存版本的修改,无缓存版本时,修改的起始偏移为负
+         * @return tokens : 词法记号序列
+         */
+        tokens lexDocument( const string& path, string_view src, Xengine::edit* change = nullptr );
+
         /**
          * @method config : 配置Manager
          * @desc : 从配置文件中读取配置信息,配置Manager的各个部分
@@ -124,18 +189,20 @@ class Manager {
         /**
          * @method loadModescTable : 加载模块描述符表
          * @desc : 从指定的空间向指定的目标加载模块描述符
+         *      优先读取带索引的abon编码mtable.abon,若不存在,读取旧版本留下的mtable.json
          * @param space : 指定要加载模块描述符的空间
          *      取值范围是Work,Root,Apps;
          * @param app : 指定应用名称
          *      当space取Apps时,app有效,若app为空,表示为所有应用分别加载模块描述符表
          * @param apps : 指定此参数表示将所有应用对应的模块描述符加载出来
          * @param descs : 指定此参数表示将加载的模块描述符表存入此对象,而不是默认目标中
-         * @param table : 指定此参数表示从此对象中读取模块描述符表
+         * @param data : 指定此参数表示直接从json文本或带索引的abon编码中读取模块描述符表,不构造文档树
+         * @param size : 文本或编码的长度
          * @return bool : 执行是否成功
          */
         bool loadModescTable( vspace space, const string& app = "" );
         bool loadModescTable( map<string,modescs>& apps );
-        bool loadModescTable( modescs& descs, Jsonz table );
+        bool loadModescTable( modescs& descs, const char* data, size_t size );
 
         /**
          * @method buildModescTable : 构建模块描述符表
@@ -157,6 +224,7 @@ class Manager {
          * @method printModescTable : 打印模块描述符表
          * @desc : 模块描述符表携带了很多信息
          *      包括当前应用,每个模块的名称,依赖,源文档描述符
+         *      模块描述符表以带索引的abon编码写入mtable.abon
          * @param space : 指定空间
          *      取值范围是Work,Root,Apps
          * @param app : 当space取值Apps时有效
@@ -54,6 +54,7 @@ struct MethodDef : public definition, public morpheme::plist {
     
     public:
 
+        MethodDef();
         bool is( cnode ) const override;
         
 };
@@ -54,6 +54,7 @@ struct MethodImpl : public implementation, public morpheme::plist {
     
     public:
 
+        MethodImpl();
         bool is( cnode ) const override;
         
 };
@@ -46,7 +46,7 @@ class modesc : public thing {
         /**
          * @member syntrees : 模块列表
          * @desc :
-         *  模块列表保存了从源文档分析的各个语法树
+         *  模块列表保存了交给语义引擎的各个语法树
          *  这些模块结构保存了与源文档之间的关联关系
          *  在报错时需要被使用,所以不能丢弃
          *  但是这些模块中的语法结构,一经分析完成,立刻
@@ -54,12 +54,63 @@ class modesc : public thing {
          */
         chainz<$ModuleGranule>    syntrees;
 
+        /**
+         * @member pristine : 原始语法树
+         * @desc :
+         *  保留语法分析直接产生的语法树,syntrees由它们准备而来
+         *  管理器常驻时,syntrees中存放的是它们的副本
+         *  语义引擎会就地修改syntrees中的语法树,所以增量构建只能在原始语法树上进行
+         */
+        chainz<$ModuleGranule>    pristine;
+
         /**
          * @member deps : 依赖表
          * @desc :
          *  在依赖补全阶段被使用,用于描述模块的依赖
          */
         depdescs deps;
+
+        /**
+         * @member srchash : 源码摘要
+         * @desc :
+         *  在构建抽象语法树时,根据所有源文档的内容计算得到
+         */
+        std::string srchash;
+
+        /**
+         * @member synhash : 语法树摘要
+         * @desc :
+         *  准备syntrees时的源码摘要
+         *  若此值与srchash不同,则语义引擎中装载的模块定义已经过期
+         */
+        std::string synhash;
+
+        /**
+         * @member face : 接口指纹
+         * @desc :
+         *  在构建抽象语法树时,根据所有源文档中其他模块可见的内容计算得到
+         *  包括模块签名,类与枚举的完整定义,以及方法与运算符实现的头部
+         *  实现的函数体,注释与空白不影响接口指纹
+         */
+        std::string face;
+
+        /**
+         * @member surface : 对外摘要
+         * @desc :
+         *  依赖此模块的模块通过此摘要感知此模块接口的变化
+         *  摘要由此模块及其依赖闭包中所有模块的接口指纹计算,仅修改实现的函数体不会引起对外摘要的变化
+         *  间接依赖的接口变化也会被感知
+         *  每次构建在依赖关系闭合且接口指纹被计算之后,由模块描述符表的survey方法统一计算
+         */
+        std::string surface;
+
+        /**
+         * @member objstamp : 目标戳
+         * @desc :
+         *  上一次成功产生目标文件时的构建戳,由模块描述符表保存
+         *  若此值与当前的构建戳相同,且目标文件存在,则模块无需重新构建
+         */
+        std::string objstamp;
         
     private:
 
@@ -97,6 +148,13 @@ class modesc : public thing {
          */
         bool appendDocument( Dengine::vfd desc );
 
+        /**
+         * @method clearDocuments : 解除源文档
+         * @desc : 重建模块描述符表时,描述符被沿用,源文档列表和依赖表被清空后重新填充
+         *      语法树和各项摘要被保留,以便增量构建
+         */
+        void clearDocuments();
+
         /**
          * @method getDocuments : 返回已绑定的文件描述符
          * @desc : 此方法在写入模块描述符或读取模块文件时使用
@@ -118,9 +176,28 @@ class modesc : public thing {
          *  语法树与抽象语法树之间存在着自下而上的联系,所以最终,从语法结构出发也可以找到语法结构所属的模块描述符
          *  透明类的定义内容在此阶段被并入模块定义序列
          * @param log : 日志仓库
-         * @return bool : 若构建成功,则构建产物存入模块描述符内,返回true,否则返回false
+         * @return bool : 若构建成功,则构建产物存入原始语法树列表,返回true,否则返回false
          */
         bool constructAbstractSyntaxTree( Lengine::logr& log );
+
+        /**
+         * @method prepareSyntaxTrees : 准备语法树
+         * @desc :
+         *  从原始语法树准备交给语义引擎的语法树,并记录其对应的源码摘要
+         *  管理器常驻时,语义引擎得到的是原始语法树的副本,否则直接使用原始语法树
+         *  装载模块定义之前调用此方法,模块定义装载之后,在卸载之前不能再调用
+         */
+        void prepareSyntaxTrees();
+
+        /**
+         * @method stamp : 构建戳
+         * @desc :
+         *  构建戳由源码摘要和所有依赖的对外摘要共同决定
+         *  构建戳不变,则模块的目标文件不变
+         *  此方法需要在survey之后使用
+         * @return std::string : 构建戳
+         */
+        std::string stamp()const;
 };
 
 using $modesc = agent<modesc>;
@@ -138,6 +215,15 @@ class modescs : public chainz<$modesc> {
 
         modescs& operator=( const modescs& );
         modescs& operator=( modescs&& );
+
+        /**
+         * @method survey : 计算对外摘要
+         * @desc :
+         *  为表中的每个模块计算一次对外摘要
+         *  每个模块的依赖闭包借助访问集合遍历,每个依赖只被访问一次,循环依赖也能终止
+         *  此方法需要在依赖关系闭合,且接口指纹被计算之后使用
+         */
+        void survey();
 };
 
 }
@@ -56,7 +56,7 @@ struct module : public ClassDef {
 
     public:
 
-        module() = default;
+        module();
         ~module() = default;
 
         module( const module& ) = delete;
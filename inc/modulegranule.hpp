@@ -5,6 +5,7 @@
 #include "definition.hpp"
 #include "implementation.hpp"
 #include "modulesignature.hpp"
+#include "arena.hpp"
 
 namespace alioth {
 
@@ -13,10 +14,19 @@ namespace alioth {
  * @desc :
  *  从单一源文档提取的语法树所包含的内容小于等于模块的全部内涵
  *  所以称之为模块颗粒,用于和其他颗粒共同构成完整的模块
+ *  模块颗粒本身在堆上分配,颗粒内的语法结构驻留在颗粒的内存场中,随颗粒一同释放
  */
 struct ModuleGranule : public node {
 
     public:
+        /**
+         * @member memory : 内存场
+         * @desc :
+         *  语法分析期间构造的语法结构都驻留在此内存场中
+         *  内存场最先构造,最后析构,保证其他成员析构时驻留对象仍然有效
+         */
+        $arena memory;
+
         /**
          * @member desc : 描述符
          * @desc :
@@ -51,6 +61,7 @@ struct ModuleGranule : public node {
         implementations impls;
 
     public:
+        ModuleGranule();
         bool is( cnode c ) const override;
 
         std::string getDocPath() const override;
@@ -102,7 +102,7 @@ struct dbra {
  */
 using dbras = chainz<dbra>;
 
-struct plist : public ConstructImpls {
+struct plist : public flatz<$ConstructImpl> {
     public:
         /**
          * @member vargs : 可变参数
@@ -66,9 +66,9 @@ class nameuc : public thing {
         $scope              mscope;     //作用域
 
     public:
-        template<typename ...Args> nameuc( atom a, Args&& ... args ) { msequence.construct(-1,forward<atom>(a)) , ( msequence.construct(-1,forward<Args>(args)), ... ); }
-        template<typename ...Args> nameuc( token a, Args&& ... args ) { msequence.construct(-1,forward<atom>(atom(a))) , ( msequence.construct(-1,forward<Args>(args)), ... ); }
-        nameuc() = default;
+        template<typename ...Args> nameuc( atom a, Args&& ... args ):thing(cthing::nameuc) { msequence.construct(-1,forward<atom>(a)) , ( msequence.construct(-1,forward<Args>(args)), ... ); }
+        template<typename ...Args> nameuc( token a, Args&& ... args ):thing(cthing::nameuc) { msequence.construct(-1,forward<atom>(atom(a))) , ( msequence.construct(-1,forward<Args>(args)), ... ); }
+        nameuc();
         nameuc(const nameuc& ) = default;
         nameuc(nameuc&&) = default;
         ~nameuc() = default;
@@ -74,10 +74,11 @@ struct node : public thing {
         /**
          * @explicit-constructor node : 显式构造函数
          * @desc :
-         *  语法树节点在构造时必须知悉父节点
+         *  语法树节点在构造时必须知悉自己的类别和父节点
+         * @param c : 具体语法结构的类别
          * @param sc : 父节点,有时候,父节点也是语法结构所在的作用域
          */
-        explicit node( $scope sc = nullptr );
+        explicit node( cthing c, $scope sc = nullptr );
 
     protected:
 
@@ -23,6 +23,7 @@ struct OperatorDef : public definition, public morpheme::plist, public morpheme:
 
     public:
 
+        OperatorDef();
         bool is( cnode ) const override;
 };
 
@@ -39,6 +39,7 @@ struct OperatorImpl : public implementation, public morpheme::plist, public morp
 
     public:
 
+        OperatorImpl();
         bool is( cnode ) const override;
 };
 
@@ -0,0 +1,236 @@
+#ifndef __pengine__
+#define __pengine__
+
+#include "chainz.hpp"
+#include "jsonz.hpp"
+#include <string>
+#include <mutex>
+
+namespace alioth {
+using namespace std;
+
+/**
+ * @class Pengine : 性能引擎
+ * @desc :
+ *  Performance Engine --- 性能引擎
+ *  性能引擎记录编译过程中每个模块的每个阶段所消耗的时间和内存
+ *  记录内容包括墙上时间,线程的处理器时间,以及进程内存峰值的增量
+ *  性能引擎可以被多个线程同时使用
+ *  性能引擎同时可以记录追踪事件,以Chrome追踪事件格式输出,用于观察编译过程的调度
+ *  未启用时,性能引擎不做任何记录,开销可以忽略
+ */
+class Pengine {
+
+    public:
+
+        /**
+         * @struct record : 记录
+         * @desc :
+         *  一个阶段的一次执行所产生的记录
+         */
+        struct record {
+            string      phase;      //阶段名称
+            string      module;     //模块名称,若阶段不属于任何模块,则为空
+            double      wall;       //墙上时间,单位ms
+            double      cpu;        //线程的处理器时间,单位ms
+            long        rss;        //进程内存峰值的增量,单位KB
+            long        bytes;      //处理的数据量,单位B,若阶段不关心数据量,则为0
+        };
+
+        /**
+         * @struct event : 追踪事件
+         * @desc :
+         *  一个完整的追踪事件,对应Chrome追踪事件格式中"ph":"X"的事件
+         */
+        struct event {
+            string      name;       //事件名称
+            string      cat;        //事件分类
+            string      module;     //模块名称,若事件不属于任何模块,则为空
+            double      ts;         //开始时间,相对于性能引擎创建的时刻,单位us
+            double      dur;        //持续时间,单位us
+            long        tid;        //线程号
+        };
+
+        /**
+         * @class scope : 测量范围
+         * @desc :
+         *  测量范围在构造时开始测量,在析构时结束测量并提交记录
+         *  若性能引擎正在追踪,测量范围同时产生一个追踪事件
+         */
+        class scope {
+            private:
+                Pengine*    mpengine;
+                string      mphase;
+                string      mmodule;
+                string      mcat;
+                bool        mreport;
+                double      mwall;
+                double      mcpu;
+                long        mrss;
+                long        mbytes;
+
+            public:
+                /**
+                 * @constructor : 构造方法
+                 * @param pengine : 性能引擎,可以为空
+                 * @param phase : 阶段或事件名称
+                 * @param module : 模块名称
+                 * @param report : 是否计入性能报告,若为假,则只产生追踪事件
+                 * @param cat : 追踪事件的分类
+                 */
+                scope( Pengine* pengine, const string& phase, const string& module, bool report = true, const string& cat = "phase" );
+                scope( const scope& ) = delete;
+                scope( scope&& );
+                ~scope();
+
+                /**
+                 * @method stop : 提前结束测量
+                 * @desc :
+                 *  结束测量并提交记录,此后析构时不再提交
+                 */
+                void stop();
+
+                /**
+                 * @method count : 计量数据量
+                 * @desc :
+                 *  累计此测量范围所处理的数据量,性能报告据此计算吞吐量
+                 * @param bytes : 数据量,单位B
+                 */
+                void count( long bytes );
+        };
+
+    private:
+
+        /**
+         * @member menabled : 是否启用
+         */
+        bool menabled;
+
+        /**
+         * @member mtracing : 是否追踪
+         */
+        bool mtracing;
+
+        /**
+         * @member mrecords : 记录
+         */
+        chainz<record> mrecords;
+
+        /**
+         * @member mevents : 追踪事件
+         */
+        chainz<event> mevents;
+
+        /**
+         * @member mepoch : 起始时刻
+         * @desc :
+         *  追踪事件的时间戳以此时刻为零点,单位ms
+         */
+        double mepoch;
+
+        /**
+         * @member mmutex : 互斥锁
+         * @desc :
+         *  保护记录容器
+         */
+        mutex mmutex;
+
+    public:
+        Pengine();
+        Pengine( const Pengine& ) = delete;
+        Pengine( Pengine&& ) = delete;
+        ~Pengine() = default;
+
+        /**
+         * @method enable : 启用或停用
+         * @param e : 是否启用
+         */
+        void enable( bool e );
+        bool enabled()const;
+
+        /**
+         * @method trace : 启用或停用追踪
+         * @param t : 是否追踪
+         */
+        void trace( bool t );
+        bool tracing()const;
+
+        /**
+         * @method measure : 测量
+         * @desc :
+         *  开始测量一个阶段,返回的测量范围被销毁时测量结束
+         * @param phase : 阶段名称
+         * @param module : 模块名称
+         * @return scope : 测量范围
+         */
+        scope measure( const string& phase, const string& module = "" );
+
+        /**
+         * @method span : 追踪
+         * @desc :
+         *  开始一个追踪事件,此事件不计入性能报告
+         * @param name : 事件名称
+         * @param cat : 事件分类
+         * @param module : 模块名称
+         * @return scope : 测量范围
+         */
+        scope span( const string& name, const string& cat, const string& module = "" );
+
+        /**
+         * @method commit : 提交记录
+         * @param rec : 记录
+         */
+        void commit( record rec );
+        void commit( event evt );
+
+        /**
+         * @method clear : 清除所有记录
+         */
+        void clear();
+
+        /**
+         * @method report : 产生报告
+         * @desc :
+         *  报告是一个json对象
+         *  phases : 各阶段的汇总
+         *  modules : 各模块中,各阶段的汇总
+         *  每个汇总都包含 wall-ms, cpu-ms, rss-kb, count 四项
+         *  若阶段计量了数据量,汇总还包含 bytes 和 mb-per-s 两项
+         * @return Jsonz : 报告
+         */
+        Jsonz report();
+
+        /**
+         * @method traceEvents : 产生追踪文档
+         * @desc :
+         *  追踪文档符合Chrome追踪事件格式,可以被chrome://tracing或Perfetto打开
+         * @return Jsonz : 追踪文档
+         */
+        Jsonz traceEvents();
+
+        /**
+         * @method epoch : 获取起始时刻
+         * @return double : 追踪事件时间戳的零点,单位ms
+         */
+        double epoch()const;
+
+        /**
+         * @method tid : 获取当前线程号
+         * @return long : 线程号
+         */
+        static long tid();
+
+        /**
+         * @method now : 获取时间
+         * @desc :
+         *  获取墙上时间,处理器时间和进程内存峰值
+         * @param wall : 墙上时间,单位ms
+         * @param cpu : 当前线程的处理器时间,单位ms
+         * @param rss : 进程内存峰值,单位KB
+         */
+        static void now( double& wall, double& cpu, long& rss );
+};
+
+}
+
+#endif
@@ -26,7 +26,7 @@ struct StackSection {
 };
 
 
-using ScopeStack = chainz<StackSection>;
+using ScopeStack = flatz<StackSection>;
 
 }
 
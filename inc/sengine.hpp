@@ -2,6 +2,8 @@
 #define __sengine__
 
 #include "imm.hpp"
+#include "bengine.hpp"
+#include "pengine.hpp"
 #include "modesc.hpp"
 #include "module.hpp"
 #include "attrdef.hpp"
@@ -85,7 +87,7 @@ class Sengine {
          * @desc :
          *  在产生目标代码时需要使用的资源
          */
-        TargetMachine* mtmachine;
+        std::unique_ptr<TargetMachine> mtmachine;
 
         /**
          * @member mttraiple : 目标平台描述
@@ -141,6 +143,13 @@ class Sengine {
          */
         bool flag_terminate;
 
+        /**
+         * @member mpengine : 性能引擎
+         * @desc :
+         *  用于记录各阶段的性能数据,可以为空
+         */
+        Pengine* mpengine;
+
     private:
 
         /**
@@ -619,14 +628,36 @@ class Sengine {
         $imm lookupElement( const token& name, $implementation sc = nullptr );
         $ConstructImpl lookupElement( $implementation sc, const token& name );
 
+        /**
+         * @method verifyTranslationUnit : 校验翻译单元
+         * @desc :
+         *  为翻译单元设置目标平台与数据布局,输出中间代码文本与校验日志
+         * @param unit : 要校验的单元
+         * @param fd : 目标文件描述符,日志和中间代码文件以它为前缀
+         * @param dengine : 文档引擎
+         * @return bool : 是否通过校验
+         */
+        bool verifyTranslationUnit( ModuleTrnsUnit unit, Dengine::vfdm fd, Dengine& dengine );
+
+        /**
+         * @method loadModuleDefinition : 从语法树装载模块定义
+         * @desc :
+         *  将语法树的内容并入模块定义,语法树的依赖描述符必须已经闭合
+         * @param mod : 要装入的模块
+         * @param trees : 描述模块的语法树
+         * @return int : 同loadModuleDefinition( $modesc mod )
+         */
+        int loadModuleDefinition( $modesc mod, const chainz<$ModuleGranule>& trees );
+
     public:
 
         /**
          * @constructor : 构造函数
          * @desc :
          *  初始化环境
+         * @param pengine : 性能引擎,可以为空
          */
-        Sengine();
+        Sengine( Pengine* pengine = nullptr );
 
         /**
          * @method loadModuleDefinition : 装载模块定义
@@ -639,12 +670,42 @@ class Sengine {
          *  2: 装入成功，发现入口
          */
         int loadModuleDefinition( $modesc mod );
+
+        /**
+         * @method replicate : 复制模块定义
+         * @desc :
+         *  以语法树的副本装载一组模块的定义,并执行定义语义分析
+         *  副本的依赖描述符必须已经闭合,此方法不修改模块描述符,也不访问管理器
+         *  管理器为每个工作线程准备一个复制了模块定义的语义引擎,工作线程借此独立地执行实现语义分析
+         *  每个语义引擎拥有独立的llvm上下文环境和目标机器,所以复制之后的语义引擎可以在另一个线程中使用
+         * @param trees : 模块描述符到语法树副本的映射
+         * @return bool : 是否所有模块都通过了定义语义分析
+         */
+        bool replicate( const std::map<$modesc,chainz<$ModuleGranule>>& trees );
+
+        /**
+         * @method hasModuleDefinition : 检查模块定义
+         * @param mod : 模块
+         * @return bool : 模块定义是否已经装入
+         */
+        bool hasModuleDefinition( $modesc mod );
+
+        /**
+         * @method unloadModuleDefinition : 卸载模块定义
+         * @desc :
+         *  将模块从语义分析器中移除,连同为其产生的翻译单元和类型符号
+         *  已装入的模块中,依赖此模块的模块引用了它的定义,所以也被一并卸载
+         *  卸载之后,模块的语法树不再被语义引擎引用,可以被替换
+         * @param mod : 要卸载的模块
+         */
+        void unloadModuleDefinition( $modesc mod );
         
         /**
          * @method performDefinitionSemanticValidation : 执行定义语义校验
          * @desc :
          *  对已装入的所有模块进行全局的定义语义检查
          *  此阶段会产生LLVM能使用的所有类型信息
+         *  已经通过检查的模块被跳过,未通过检查的模块被卸载
          * @return bool : 是否通过语义校验
          */
         bool performDefinitionSemanticValidation();
@@ -667,9 +728,10 @@ class Sengine {
          * @param unit : 要翻译的单元
          * @param fd : 文件描述符
          * @param dengine : 文档引擎
+         * @param image : 若指定此参数,目标文件的内容被保留在此对象中,供链接步骤使用
          * @return bool : 是否成功
          */
-        bool triggerBackendTranslation( ModuleTrnsUnit unit, Dengine::vfdm fd, Dengine& dengine );
+        bool triggerBackendTranslation( ModuleTrnsUnit unit, Dengine::vfdm fd, Dengine& dengine, string* image = nullptr );
 
         /**
          * @method getLog : 获取所有日志
@@ -678,6 +740,13 @@ class Sengine {
          * @return Lengine::logr : 日志仓库
          */
         Lengine::logr getLog();
+
+        /**
+         * @method clearLog : 清空日志
+         * @desc :
+         *  语义引擎在多次构建之间常驻时,每次构建之前清空上一次构建的日志
+         */
+        void clearLog();
 };
 
 }
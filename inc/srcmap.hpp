@@ -0,0 +1,60 @@
+#ifndef __srcmap__
+#define __srcmap__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace alioth {
+
+/**
+ * @class srcmap : 源码映射
+ * @desc :
+ *  源码映射把所有被分析的源文档排布在同一个32位的位置空间中,每个文档路径占据一段区域
+ *  词法记号只记录自己在位置空间中的起止位置,行列号和字面文本都在需要时通过源码映射恢复
+ *  文档被再次登记时,若新文本能容纳在原区域中,区域的起点保持不变
+ *  所以修改之前的记号位置依然有效,修改之后的记号只需平移
+ *  区域容量不足时文档被迁移到新的区域,原区域被回收,引用原区域的记号随之失效
+ *  每个路径只占据一段区域,所以常驻进程反复分析同一批文档时,源码映射的大小保持有界
+ *  源码映射是全局的,可以被多个线程同时使用
+ *  位置0不属于任何区域,表示没有位置
+ */
+class srcmap {
+
+    public:
+        /**
+         * @method enter : 登记文档
+         * @desc :
+         *  将文档的文本存入路径对应的区域,并建立行表
+         *  文本中偏移为n的字节,其位置为区域起点加n,文本末尾的位置也属于区域
+         * @param path : 文档路径
+         * @param text : 文档的文本
+         * @return uint32_t : 区域的起点,位置空间耗尽时返回0
+         */
+        static uint32_t enter( const std::string& path, std::string_view text );
+
+        /**
+         * @method locate : 定位
+         * @desc :
+         *  通过行表将位置恢复为行列号,行列都从1开始,列以字节计
+         * @param loc : 位置
+         * @param line : 行
+         * @param column : 列
+         * @return bool : 位置是否属于某个区域,若不属于,行列都为0
+         */
+        static bool locate( uint32_t loc, int& line, int& column );
+
+        /**
+         * @method text : 获取文本
+         * @desc :
+         *  获取[b,e)之间的文本,两个位置必须属于同一个区域,否则返回空文本
+         * @param b : 起始位置
+         * @param e : 终止位置
+         * @return std::string : 文本
+         */
+        static std::string text( uint32_t b, uint32_t e );
+};
+
+}
+
+#endif
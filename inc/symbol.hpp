@@ -0,0 +1,108 @@
+#ifndef __symbol__
+#define __symbol__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace alioth {
+
+/**
+ * @class symbol : 符号
+ * @desc :
+ *  符号是被驻留的文本的句柄,相同的文本总是对应相同的符号
+ *  符号只占32位,复制符号不会复制文本,判断两个符号是否相等只需比较整数
+ *  驻留表是全局的,可以被多个线程同时使用
+ *  被驻留的文本在进程结束前不会被释放,通过句柄取得的文本引用始终有效
+ *  只有标识符,关键字和运算符标签这类有限的词汇会被驻留,字面量的文本留在源码映射中
+ *  符号0对应空文本,默认构造的符号就是空文本
+ */
+class symbol {
+
+    private:
+        /**
+         * @member mid : 符号编号
+         * @desc :
+         *  文本在驻留表中的编号
+         */
+        uint32_t mid;
+
+    public:
+        /**
+         * @constructor : 构造方法
+         * @desc :
+         *  @form<1> : 构造空文本符号
+         *  @form<2~4> : 驻留文本,构造对应的符号
+         */
+        symbol():mid(0) {}
+        symbol( std::string_view text );
+        symbol( const std::string& text );
+        symbol( const char* text );
+        symbol( const symbol& ) = default;
+        symbol& operator=( const symbol& ) = default;
+        ~symbol() = default;
+
+        /**
+         * @method intern : 驻留文本
+         * @desc :
+         *  若文本已经被驻留,返回其编号,否则将文本加入驻留表并分配新的编号
+         *  驻留表耗尽时返回0,并记录耗尽状态
+         * @param text : 文本
+         * @return uint32_t : 符号编号
+         */
+        static uint32_t intern( std::string_view text );
+
+        /**
+         * @method exhausted : 检查驻留表是否耗尽
+         * @desc :
+         *  驻留表耗尽之后,新的文本都得到空文本符号,名称会被混淆
+         *  此时任何分析结果都不可信,调用者应当报告错误并终止构建
+         * @return bool : 驻留表是否耗尽
+         */
+        static bool exhausted();
+
+        /**
+         * @method text : 获取文本
+         * @desc :
+         *  通过编号获取被驻留的文本,此方法不加锁
+         * @param id : 符号编号,必须是驻留表分配的编号
+         * @return const std::string& : 文本
+         */
+        static const std::string& text( uint32_t id );
+
+        uint32_t id()const { return mid; }
+        const std::string& str()const { return text(mid); }
+        operator const std::string&()const { return text(mid); }
+
+        /**
+         * @method assign : 设置文本
+         * @desc :
+         *  驻留[b,e)之间的文本,并使符号指向它
+         */
+        void assign( const char* b, const char* e ) { mid = intern(std::string_view(b,e-b)); }
+        void clear() { mid = 0; }
+
+        bool empty()const { return mid == 0; }
+        size_t size()const { return str().size(); }
+        size_t length()const { return str().size(); }
+        char operator[]( size_t i )const { return str()[i]; }
+        char back()const { return str().back(); }
+        std::string::const_iterator begin()const { return str().begin(); }
+        std::string::const_iterator end()const { return str().end(); }
+
+        /**
+         * @operator == : 判等
+         * @desc :
+         *  两个符号之间只比较编号,符号与字符串之间比较文本,后者不会驻留字符串
+         */
+        bool operator==( const symbol& an )const { return mid == an.mid; }
+        bool operator!=( const symbol& an )const { return mid != an.mid; }
+        bool operator==( const char* an )const { return str() == an; }
+        bool operator!=( const char* an )const { return str() != an; }
+        bool operator==( const std::string& an )const { return str() == an; }
+        bool operator!=( const std::string& an )const { return str() != an; }
+};
+
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include "alioth.hpp"
 #include "vt.hpp"
 #include "vn.hpp"
+#include "symbol.hpp"
+#include <cstdint>
 #include <string>
 
 namespace alioth {
@@ -83,8 +85,9 @@ enum class CT {
  * @class token : 记号
  * @desc :
  *  记号可以用于表示一个词法符号或一个语法符号
- *  记号携带了此记号的文本内容和起止位置
- *  对于一个非终结符,文本内容无效
+ *  记号只携带符号,文本的符号和在源码映射中的起止位置,共16字节
+ *  行列号由源码映射的行表恢复,字面量和非终结符的书写形式也从源码映射中取得
+ *  记号不持有任何堆内存,可以被廉价地复制
  */
 class token {
 
@@ -104,40 +107,27 @@ class token {
         VN          in;
 
         /**
-         * @member bl : 起始行
-         * @desc :
-         *  用于标定此记号在源代码中的起始行
-         */
-        int         bl;
-
-        /**
-         * @member bc : 起始列
-         * @desc :
-         *  用于标定此记号在源代码的起始列
-         */
-        int         bc;
-
-        /**
-         * @member el : 终止行
+         * @member tx : 文本
          * @desc :
-         *  用于标定此记号在源代码中的终止行
+         *  标识符,关键字和运算符的书写形式被驻留为符号
+         *  字面量的文本不进入驻留表,此成员为空,书写形式从源码映射中取得
+         *  非终结符通常没有文本,只有作为名称使用的运算符标签保留其书写形式
          */
-        int         el;
+        symbol      tx;
 
         /**
-         * @member ec : 终止列
+         * @member bo : 起始位置
          * @desc :
-         *  用于标定此记号在源代码中的终止列
+         *  记号的第一个字节在源码映射中的位置,0表示记号没有位置
          */
-        int         ec;
+        uint32_t    bo;
 
         /**
-         * @member tx : 文本
+         * @member eo : 终止位置
          * @desc :
-         *  用于记录记号实际上的书写形式
-         *  对非终结符,此内容不一定有效
+         *  记号最后一个字节之后的位置
          */
-        std::string tx;
+        uint32_t    eo;
 
     public:
         /**
@@ -175,11 +165,21 @@ class token {
          * @desc :
          *  此方法先查询词汇表,若终结符与其中某项对应
          *  直接输出对应文本,忽略tx成员.
-         *  若终结符不在词汇表中记录,则直接返回tx成员.
+         *  若终结符不在词汇表中记录,则返回tx成员,字面量的文本从源码映射中取得.
+         *  非终结符若没有文本,则由其覆盖的源码重新拼接出书写形式,此过程开销较大,只应在诊断时使用
          * @return std::string
          */
         operator std::string()const;
 
+        /**
+         * @method sym : 作符号使用
+         * @desc :
+         *  返回书写格式对应的符号,规则与作文本使用时相同
+         *  比较名称时应当比较符号,而不是比较文本
+         * @return symbol
+         */
+        symbol sym()const;
+
         /**
          * @operator bool : 作布尔使用
          * @desc :
@@ -208,7 +208,7 @@ class token {
         template<typename...Args>bool is(Args ...args)const{return (... or is(args));}
 };
 
-using tokens = chainz<token>;
+using tokens = flatz<token>;
 
 }
 
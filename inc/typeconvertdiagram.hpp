@@ -32,7 +32,7 @@ struct tcp : public thing {
         const agent<tcp> next;
 
     public: 
-        tcp( ConvertAction c = Nocando, $typeuc d = nullptr, $typeuc s = nullptr,agent<tcp> n = nullptr):ca(c),dst(d),src(s),next(n){}
+        tcp( ConvertAction c = Nocando, $typeuc d = nullptr, $typeuc s = nullptr,agent<tcp> n = nullptr):thing(cthing::tcp),ca(c),dst(d),src(s),next(n){}
         tcp( const tcp& an ):tcp(an.ca,an.dst,an.src,an.next?new tcp(*an.next):nullptr) {}
         tcp( const tcp& an, agent<tcp> n ):tcp(an.ca,an.dst,an.src,n){}
         tcp( tcp&& an ) = delete;
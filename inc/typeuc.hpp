@@ -76,7 +76,7 @@ class typeuc : public thing {
         typeuc( $typeuc s, bool constrainted );
         typeuc( $ClassDef def );
         typeuc( const nameuc& nm );
-        typeuc() = default;
+        typeuc();
         typeuc( const typeuc& ) = default;
         typeuc( typeuc&& ) = default;
         ~typeuc() = default;
@@ -7,7 +7,7 @@ namespace alioth {
  * @enum-class VN : 非终结符ID
  * @desc : 用于区分不同非终结符的ID
  */
-enum class VN {
+enum class VN : short {
     TERMINAL,
     MODULE,
     DEPENDENCY,
@@ -7,7 +7,7 @@ namespace alioth {
  * @enum-class VT : 终结符ID
  * @desc : 用于简单区分不同的终结符的枚举
  */
-enum class VT {
+enum class VT : short {
     R_ERR,               //保留终结符,错误的文法符号
     R_BEG,               //保留终结符,文法开始
     R_END,               //保留终结符,文法结束
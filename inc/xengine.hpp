@@ -4,6 +4,7 @@
 #include "jsonz.hpp"
 #include "token.hpp"
 #include <istream>
+#include <string_view>
 
 namespace alioth {
 
@@ -16,68 +17,61 @@ namespace alioth {
  */
 class Xengine {
 
-    private:
+    public:
         /**
-         * @member __table : 词汇表
-         * @desc :
-         *  词汇表用于描述词法符号与书写形式的一一对应关系
-         *  多数终结符都是拥有一一对应书写形式的
-         *  词汇表会在第一个词法引擎实例被创建时初始化
-         */
-        static Jsonz __table;
+         * @struct edit : 修改
+         * @desc :
+         *  描述对源文档的一处连续修改,旧文档中[起始偏移,终止偏移)之间的字节被替换为text
+         *  偏移以字节计,从文档开头的0开始
+         *  起始偏移为负的修改是无效的修改,表示没有可用的旧版本
+         *  重新同步的位置由relexSourceCode填写,为负表示新旧记号序列没有重新同步
+         */
+        struct edit {
+            int         b = -1;     //被替换内容在旧文档中的起始偏移
+            int         e = -1;     //被替换内容在旧文档中的终止偏移
+            std::string text;       //替换后的内容
+            int         s = -1;     //重新同步的位置在新文档中的偏移,此后的记号都是平移后的旧记号
+
+            /**
+             * @method reach : 计算修改在新文档中的终止偏移
+             * @return int : 终止偏移
+             */
+            int reach()const;
+
+            /**
+             * @method delta : 计算平移量
+             * @desc :
+             *  旧文档中位于修改之后的内容,在新文档中向后平移的字节数
+             * @return int : 平移量,可以为负
+             */
+            int delta()const;
+        };
 
     private:
         /**
-         * @member pre : 字节预览
+         * @member path : 文档路径
          * @desc :
-         *  扫描过程中,每个决策开始之前,当前输入字节的预览
+         *  被分析的文本以此路径登记在源码映射中
          */
-        int pre;
+        std::string path;
 
         /**
-         * @member off : 偏移量
+         * @member base,org : 区域起点和缓冲区起点
          * @desc :
-         *  此成员被"单词测试"和"前缀测试"使用
-         */
-        int off;
-
-        /**
-         * @member begl,begc : 当前源代码行列
-         * @desc :
-         *  在词法分析过程中跟踪记录当前行列
+         *  缓冲区中地址为p的字节,其位置为base+(p-org)
          *  此二者被用来定位词法符号
          */
-        int begl;
-        int begc;
-
-        /**
-         * @member target : 目标状态
-         * @desc :
-         *  在前缀测试中,若前缀匹配成功,跳转的目标状态值
-         */
-        int target;
-
-        /**
-         * @member fixed : 确定样本
-         * @desc :
-         *  在单词测试和前缀测试中使用的样本
-         */
-        std::string fixed;
+        uint32_t base;
+        const char* org;
 
         /**
          * @member state : 当前状态
          * @desc :
-         *  词法分析有限状态机的当前状态
+         *  词法分析流程的状态
+         *  1表示继续分析,-1表示微型语法分析器要求停止分析
          */
         int state;
 
-        /**
-         * @member stay : 停滞口令
-         * @desc :
-         *  若此值为true,有限状态机停滞一个字节,再决策一次
-         */
-        bool stay;
-
         /**
          * @member T : 临时记号
          * @desc :
@@ -85,13 +79,6 @@ class Xengine {
          */
         token T;
 
-        /**
-         * @member hit : 命中符号
-         * @desc :
-         *  当"赋值测试"命中时,用于替换T.id的终结符类型
-         */
-        VT hit;
-
         /**
          * @member synst : 语法分析器状态
          * @desc :
@@ -106,14 +93,6 @@ class Xengine {
          */
         tokens ret;
 
-        /**
-         * @member pis : 源代码输入流指针
-         * @desc :
-         *  此成员在词法分析流程中被使用
-         *  在词法分析开始时被初始化.
-         */
-        std::istream* pis;
-
         /**
          * @member limit : 限制
          * @desc :
@@ -122,122 +101,92 @@ class Xengine {
          */
         bool limit;
 
-    private:
-
         /**
-         * @method begin : 启动词法分析
+         * @member strip : 剔除
          * @desc :
-         *  此方法为启动一次词法分析流程准备环境.
-         *  初始化所有所需的变量.
-         * @param is : 源代码输入流
-         * @param li : 限制
+         *  此成员描述词法分析流程是否剔除空白和注释
+         *  若剔除,则产物中不包含空白和注释,语法分析器可以直接使用产物
          */
-        void begin( std::istream& is, bool li );
+        bool strip;
 
         /**
-         * @method goon : 继续
+         * @member trivia : 旁路
          * @desc :
-         *  考虑停滞口令后,输入一个字节,继续检查下一个字节
-         *  若停滞口令有效,则失活停滞口令,并结束
+         *  剔除空白和注释时,若此成员不为空,注释被依次存入旁路容器
+         *  空白总是被丢弃
          */
-        void goon();
+        tokens* trivia;
 
-        /**
-         * @method check : 确认输入
-         * @desc :
-         *  确认当前正在构建的词法符号已经完成,将其输入分析产物序列
-         *  同时,考虑词法分析范围限制,使用微型语法分析算法做出状态决策
-         * @param t : 确认的词法符号
-         * @param s : 是否连同当前正在检查的预览字节一起确认输入
-         */
-        void check( VT t, bool s );
-
-        /**
-         * @method test : 开始一次单词测试
-         * @desc :
-         *  单词测试用于测试接下来的输入内容是否与词汇表中的指定单词的书写形式相同
-         *  由当前已分析的前缀最多仅能引导一种确定词汇时,使用单词测试简化分析流程
-         *  单词测试流程由词法分析算法包含
-         *  此方法用于进入单词测试流程
-         * @param v : 要测试的词法符号
-         * @param o : 开始测试时已经扫描的前缀的偏移量
-         */
-        void test( VT v, int o );
-
-        /**
-         * @method prefix : 开始一次前缀测试
-         * @desc :
-         *  前缀测试用于测试输入序列是否满足指定前缀,若满足,则跳转到指定状态进行后续处理
-         *  前缀测试用于应对前缀相同的多个不同词汇的集中扫描处理.
-         *  此方法用于开始一次前缀测试
-         * @param s : 前缀测试样板
-         * @param o : 前缀测试开始的偏移量
-         * @param t : 前缀测试通过后应当跳转的状态
-         */
-        void prefix( const char* s, int o, int t );
+    private:
 
         /**
-         * @method assign : 开始一次赋值测试
+         * @method begin : 启动词法分析
          * @desc :
-         *  当已分析的内容足以成为运算符但也可能与'='联结成为赋值运算符,使用赋值测试来统一处理逻辑,消除重复代码.
-         *  此方法用于进入赋值测试所需的状态.
-         * @param h : 当赋值测试命中时,成立的词法符号
-         * @param m : 当赋值测试未通过时,成立的词法符号
+         *  此方法为启动一次词法分析流程准备环境.
+         *  初始化所有所需的变量,区域起点和缓冲区起点须在此之前设置.
+         * @param li : 限制
+         * @param st : 是否剔除空白和注释
+         * @param tr : 旁路容器,仅在剔除空白和注释时有效
          */
-        void assign( VT h, VT m );
+        void begin( bool li, bool st = false, tokens* tr = nullptr );
 
         /**
-         * @method sequence : 开始一个序列扫描
+         * @method check : 确认输入
          * @desc :
-         *  序列扫描用于扫描由引号包含的,表示文本的内容
-         * @param h : 当扫描命中时,成立的词法符号
+         *  确认一个词法符号已经完成,将其输入分析产物序列
+         *  同时,考虑词法分析范围限制,使用微型语法分析算法做出状态决策
+         * @param t : 确认的词法符号
+         * @param b : 词法符号文本的开始
+         * @param e : 词法符号文本的结束
          */
-        void sequence( VT h );
+        void check( VT t, const char* b, const char* e );
 
         /**
-         * @method islabelb : 判断字符是否能用作标识符的开头
+         * @method step : 推进一个词法符号
          * @desc :
-         *  此方法用于判断字节是否能用作标识符的开头
-         * @param c : 要判断的字符
-         * @return bool
+         *  使用词法自动机从p开始吸收一个词法符号,并确认此词法符号
+         * @param p : 当前位置,被推进到词法符号的结束
+         * @param e : 缓冲区的结束
          */
-        static bool islabelb( int c );
+        void step( const char*& p, const char* e );
 
-        /**
-         * @method islabel : 判断字符是否可以用作标识符的内容
-         * @desc :
-         *  此方法用于判断字符是否可用作标识符的内容
-         * @param c : 要判断的字符
-         * @return bool
-         */
-        static bool islabel( int c );
 
         /**
-         * @method extractTokens : 从输入流提取词法符号序列
+         * @method extractTokens : 从缓冲区提取词法符号序列
          * @desc :
-         *  此方法使用词法分析算法从输入流提取词法符号序列
+         *  此方法使用词法自动机从连续的缓冲区提取词法符号序列,缓冲区通常是文档引擎产生的文件映像
+         *  词法自动机是在编译期由词汇表生成的确定有限自动机,每个字节只需一次查表
+         *  缓冲区首先被登记到源码映射,只有被保留的标识符会被驻留,字面量的文本留在源码映射中
+         *  源码映射的位置空间耗尽时,产物只包含R_BEG和R_END,且R_BEG没有位置
+         *  驻留表耗尽时,无法被驻留的标识符成为无效记号R_ERR
          *  此方法使用词法分析引擎存储中间结果,中间内容
          *  所以一个词法引擎实例不能在多线程中使用
-         * @param is : 输入流
+         * @param b : 缓冲区的开始
+         * @param e : 缓冲区的结束
          * @param limit : 是否限制扫描范围,此参数为真,则只分析模块签名
+         * @param strip : 是否剔除空白和注释
+         * @param trivia : 旁路容器,用于接收被剔除的注释,可以为空
          * @return tokens : 返回词法序列
          */
-        tokens extractTokens( std::istream& is, bool limit );
+        tokens extractTokens( const char* b, const char* e, bool limit, bool strip = false, tokens* trivia = nullptr );
 
         /**
-         * @method init : 初始化
+         * @method extractTokens : 从输入流提取词法符号序列
          * @desc :
-         *  初始化词法分析引擎的公共基础资源
+         *  此方法将输入流的内容读入缓冲区,再从缓冲区提取词法符号序列
          */
-        static void init();
+        tokens extractTokens( std::istream& is, bool limit, bool strip = false, tokens* trivia = nullptr );
+
     
     public:
         /**
          * @constructor : 构造方法
          * @desc :
          *  构造方法用于初始化词法引擎所需的资源,构造词法引擎实例
+         *  此实例分析的文本都以此路径登记在源码映射中,同一路径的文本共享一段区域
+         * @param path : 文档路径
          */
-        Xengine();
+        Xengine( const std::string& path = std::string() );
 
         /**
          * @destructor : 析构方法
@@ -256,6 +205,57 @@ class Xengine {
          */
         tokens parseSourceCode( std::istream& is );
 
+        /**
+         * @method parseSourceCode : 解析源代码
+         * @desc :
+         *  分析源代码,产生不含空白和注释的词法记号序列,语法分析器不必再剔除它们
+         *  注释被依次存入旁路容器,以便需要调试信息的地方使用
+         * @param is : 源代码输入流
+         * @param trivia : 旁路容器,若为空,则注释被丢弃
+         * @return tokens : 产生的词法记号序列
+         */
+        tokens parseSourceCode( std::istream& is, tokens* trivia );
+
+        /**
+         * @method parseSourceCode : 解析源代码
+         * @desc :
+         *  直接从内存中的源代码产生不含空白和注释的词法记号序列,不经过输入流
+         *  源代码可以来自文档引擎的文件映像,其文本被复制到源码映射中,词法分析结束后,词法记号不再引用源代码
+         * @param src : 源代码的开始
+         * @param size : 源代码的长度
+         * @param trivia : 旁路容器,若为空,则注释被丢弃
+         * @return tokens : 产生的词法记号序列
+         */
+        tokens parseSourceCode( const char* src, size_t size, tokens* trivia );
+
+        /**
+         * @method relexSourceCode : 增量地重新解析源代码
+         * @desc :
+         *  在旧文档的词法记号序列上应用一处修改,只重新分析受损的区域
+         *  分析从修改之前最后一个完好的词法记号之后开始
+         *  越过修改的终点后,一旦新的词法符号边界与某个旧词法记号的起点重合,两个序列便重新同步
+         *  此后的旧词法记号被平移后直接复用
+         *  旧序列必须是以同一路径分析得到的不含空白和注释的完整词法记号序列,即parseSourceCode(src,size,nullptr)的产物
+         *  若新文本不能容纳在旧文本的区域中,旧记号的位置全部失效,此时完整地分析新文本,并使修改无效
+         * @param prev : 旧文档的词法记号序列
+         * @param src : 新文档的开始
+         * @param size : 新文档的长度
+         * @param ed : 从旧文档到新文档的修改,重新同步的位置被写回其中
+         * @return tokens : 新文档的词法记号序列,与完整分析新文档的结果相同
+         */
+        tokens relexSourceCode( const tokens& prev, const char* src, size_t size, edit& ed );
+
+        /**
+         * @method diff : 比较文档
+         * @desc :
+         *  比较新旧两个版本的文档,去除公共的前缀和后缀,得到覆盖所有差异的一处修改
+         *  两个版本相同时,得到位于文档末尾的空修改
+         * @param before : 旧文档
+         * @param after : 新文档
+         * @return edit : 修改
+         */
+        static edit diff( std::string_view before, std::string_view after );
+
         /**
          * @method parseModuleSignature : 解析模块签名
          * @desc :
@@ -266,26 +266,63 @@ class Xengine {
          *  其中仅包含模块签名所对应的词法记号
          */
         tokens parseModuleSignature( std::istream& is );
+        tokens parseModuleSignature( const char* src, size_t size );
 
         /**
          * @method written : 书写格式
          * @desc :
          *  written方法用于将词法符号的书写形式写入字符串
          *  对于在词汇表上的词法符号,本方法返回词法符号表
-         *  对词汇表不能一一对应的词法符号,本方法返回文本内容
+         *  对词汇表不能一一对应的词法符号,本方法返回文本内容,字面量的文本从源码映射中取得
+         *  对非终结符,本方法返回概括文本
          * @param t : 词法符号
          * @return std::string : 书写格式字符串
          */
         static std::string written( const token& t );
 
         /**
-         * @method isLabel : 检查标识符
+         * @method symbolize : 书写格式的符号
          * @desc :
-         *  检查一个字符串是否能作为标识符存在
-         * @param s : 要检查的字符串
-         * @return bool : 检查结果
+         *  与written方法规则相同,但返回被驻留的符号,不产生任何拷贝
+         *  关键字的符号在第一次使用时被驻留,此后只需查表
+         *  作为名称使用的运算符标签在归约时已经驻留了书写形式,其他非终结符和字面量在此时才被驻留
+         * @param t : 词法符号
+         * @return symbol : 书写格式对应的符号
+         */
+        static symbol symbolize( const token& t );
+
+        /**
+         * @method phrase : 概括文本
+         * @desc :
+         *  重新分析非终结符所覆盖的源码,将其中的词法记号拼接成概括文本
+         *  相邻的两个记号都以字母或数字接壤时,以一个空格分隔,其余记号直接拼接
+         *  记号的文本直接取自源码,所以重新分析不会驻留任何字面量
+         * @param t : 非终结符
+         * @return std::string : 概括文本,若记号没有位置,则为空
          */
-        static bool isLabel( const std::string& s );
+        static std::string phrase( const token& t );
+
+        /**
+         * @method keyword : 识别关键字
+         * @desc :
+         *  使用编译期生成的完美散列表,查找一段文本所对应的关键字
+         *  词法自动机不为标识符形式的关键字建立状态,接受标识符时通过此方法识别关键字
+         *  此方法不分配任何内存
+         * @param s : 文本的开始
+         * @param n : 文本的长度
+         * @return VT : 关键字,若文本不是关键字,则返回LABEL
+         */
+        static VT keyword( const char* s, size_t n );
+
+        /**
+         * @method spelling : 书写形式
+         * @desc :
+         *  查找关键字的书写形式,词汇表在编译期生成
+         * @param v : 终结符
+         * @return const char* : 书写形式,若终结符不是关键字,则返回nullptr
+         */
+        static const char* spelling( VT v );
+
 
         /**
          * @method extractText : 提取文本
@@ -297,17 +334,6 @@ class Xengine {
          * @return std::string : 文本内容
          */
         static std::string extractText( const token& t );
-
-        /**
-         * @method priority : 提取优先级
-         * @desc :
-         *  此方法用于提取运算符的优先级
-         *  若传入的词法记号不是运算符,则方法返回0
-         *  运算符优先级越高,返回值越高
-         * @param t : 要检查的词法符号
-         * @return int : 词法符号的优先级
-         */
-        static int priority( const token& t );
 };
 
 }
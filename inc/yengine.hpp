@@ -4,6 +4,7 @@
 #include "alioth.hpp"
 #include "modesc.hpp"
 #include "lengine.hpp"
+#include "xengine.hpp"
 #include "depdesc.hpp"
 #include "attrdef.hpp"
 #include "enumdef.hpp"
@@ -252,6 +253,31 @@ class Yengine {
          */
         token constructOperatorLabel( tokens::iterator& it, Lengine::logs& log, $scope sc, morpheme::opsig& sub );
 
+        /**
+         * @method constructExpressionImplementation : 按结合力构建表达式
+         * @desc :
+         *  以优先级爬升的方式构建表达式,只有左结合力大于power的中缀运算符会被吸收
+         *  此方法只移动迭代器而不归约记号序列,每个表达式的phrase覆盖其书写范围
+         * @param it : 输入序列
+         * @param log : 日志器
+         * @param scope : 作用域
+         * @param power : 结合力下限
+         * @return $ExpressionImpl : 表达式
+         */
+        $ExpressionImpl constructExpressionImplementation( tokens::iterator& it, Lengine::logs& log, $scope scope, int power );
+
+        /**
+         * @method constructExpressionOperand : 构建算子
+         * @desc :
+         *  构建一个不含中缀运算符的表达式,即前缀运算,值,名称用例,括号表达式或构造表达式
+         *  以及紧随其后的后缀运算,下标运算,成员运算和调用
+         * @param it : 输入序列
+         * @param log : 日志器
+         * @param scope : 作用域
+         * @return $ExpressionImpl : 表达式
+         */
+        $ExpressionImpl constructExpressionOperand( tokens::iterator& it, Lengine::logs& log, $scope scope );
+
     public:
 
         /**
@@ -265,6 +291,35 @@ class Yengine {
          */
         $ModuleGranule constructSyntaxTree( tokens& is, Lengine::logs& log );
 
+        /**
+         * @method reconstructSyntaxTree : 增量地重新构建语法树
+         * @desc :
+         *  在旧文档的语法树上应用一处修改,只重新构建受到修改影响的顶层类定义,枚举定义,方法实现和运算符实现
+         *  完全位于修改之前的顶层结构被直接复用,空修改直接返回旧语法树
+         *  起始于修改终点之后的顶层结构也被复用,修改改变了文档长度时,它们被复制,副本中的记号位置平移修改的长度差
+         *  复用之后的结构还要求词法分析在其之前重新同步,且新记号序列在其起点处仍是它的首个记号,否则其后的内容全部重新构建
+         *  若修改触及模块签名,或旧语法树已经交给语义引擎处理过,则完整地构建语法树
+         *  语义引擎会在语法树上就地解析类型并重组定义,所以只有未经语义分析的语法树才能被复用
+         * @param prev : 旧文档的语法树
+         * @param is : 新文档的记号输入序列
+         * @param ed : 从旧文档到新文档的修改,须携带relexSourceCode写回的重新同步位置
+         * @param log : 日志器
+         * @return $ModuleGranule : 新文档的语法树,即被就地更新的旧语法树,复用的结构保持原有的作用域
+         *  构建失败时返回nullptr,旧语法树保持不变
+         */
+        $ModuleGranule reconstructSyntaxTree( $ModuleGranule prev, tokens& is, const Xengine::edit& ed, Lengine::logs& log );
+
+        /**
+         * @method duplicateSyntaxTree : 复制语法树
+         * @desc :
+         *  深度复制语法树,副本驻留在自己的内存场中,与原语法树不共享任何语法结构
+         *  副本内部的作用域指向副本中对应的结构,被多处引用的结构在副本中仍然只有一份
+         *  语义引擎会就地修改交给它的语法树,常驻时原语法树被保留下来,以供增量构建使用,语义引擎只接触副本
+         * @param origin : 原语法树
+         * @return $ModuleGranule : 语法树的副本
+         */
+        $ModuleGranule duplicateSyntaxTree( $ModuleGranule origin );
+
         /**
          * @method detectModuleSignature : 检测模块签名
          * @desc :
@@ -340,8 +395,6 @@ class Yengine {
          */
         anything readSyntaxStructure( Jsonz json );
 
-        
-        int prio(const token& it)const;
 };
 
 }
@@ -0,0 +1,129 @@
+#ifndef __arena_cpp__
+#define __arena_cpp__
+
+#include "arena.hpp"
+#include <new>
+
+namespace alioth {
+
+/**
+ * @member active : 当前线程上生效的内存场
+ */
+static thread_local arena* active = nullptr;
+
+static constexpr size_t alignment = alignof(std::max_align_t);
+static constexpr size_t header = (sizeof(size_t)*3 + alignment - 1) / alignment * alignment;
+static constexpr size_t initial = 64 << 10;
+static constexpr size_t largest = 4 << 20;
+
+thing::thing():thing(cthing::thing) {}
+
+thing::thing( cthing c ):ref_count(0),mcategory(c) {
+    if( active and active->claim(this) ) ref_count = -1;
+}
+
+thing::thing( const thing& an ):phrase(an.phrase),ref_count(0),mcategory(an.mcategory) {
+    if( active and active->claim(this) ) ref_count = -1;
+}
+
+thing::thing( thing&& an ):phrase(std::move(an.phrase)),ref_count(0),mcategory(an.mcategory) {
+    if( active and active->claim(this) ) ref_count = -1;
+}
+
+void* thing::operator new( size_t size ) {
+    if( active ) return active->allocate(size);
+    return ::operator new(size);
+}
+
+void thing::operator delete( void* p ) {
+    if( active and active->discard(p) ) return;
+    ::operator delete(p);
+}
+
+arena::scope::scope( arena* a ):mprev(active) {
+    active = a;
+}
+
+arena::scope::~scope() {
+    active = mprev;
+}
+
+arena::arena():thing(cthing::arena),mblocks(nullptr),mbytes(0),mdepth(1) {
+
+}
+
+arena::~arena() {
+    release();
+}
+
+arena* arena::current() {
+    return active;
+}
+
+void* arena::allocate( size_t size ) {
+    size = (size + alignment - 1) / alignment * alignment;
+    if( !mblocks or mblocks->used + size > mblocks->size ) {
+        size_t cap = mblocks ? mblocks->size * 2 : initial;
+        if( cap > largest ) cap = largest;
+        if( cap < size ) cap = size;
+        auto b = (block*)::operator new(header + cap);
+        b->next = mblocks;
+        b->size = cap;
+        b->used = 0;
+        mblocks = b;
+    }
+    void* p = (char*)mblocks + header + mblocks->used;
+    mblocks->used += size;
+    mbytes += size;
+    mpending.push_back(p);
+    return p;
+}
+
+bool arena::claim( thing* t ) {
+    if( mpending.empty() or mpending.back() != (void*)t ) return false;
+    mpending.pop_back();
+    mthings.push_back(t);
+    return true;
+}
+
+bool arena::discard( void* p ) {
+    if( mpending.empty() or mpending.back() != p ) return false;
+    mpending.pop_back();
+    return true;
+}
+
+void arena::retain( $arena an ) {
+    if( !an or an == this ) return;
+    mretains << an;
+    if( an->mdepth + 1 > mdepth ) mdepth = an->mdepth + 1;
+}
+
+size_t arena::depth()const {
+    return mdepth;
+}
+
+size_t arena::size()const {
+    return mbytes;
+}
+
+size_t arena::count()const {
+    return mthings.size();
+}
+
+void arena::release() {
+    for( auto i = mthings.rbegin(); i != mthings.rend(); i++ ) (*i)->~thing();
+    mthings.clear();
+    mpending.clear();
+    while( mblocks ) {
+        auto b = mblocks;
+        mblocks = b->next;
+        ::operator delete(b);
+    }
+    mbytes = 0;
+    mretains.clear();
+    mdepth = 1;
+}
+
+}
+
+#endif
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+AttrDef::AttrDef():definition(cthing::AttrDef) {}
+
 bool AttrDef::is( cnode n ) const {
     return n == DEFINITION or n == ATTRIBUTEDEF;
 }
@@ -0,0 +1,137 @@
+#ifndef __bengine_cpp__
+#define __bengine_cpp__
+
+#include "bengine.hpp"
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Target/TargetOptions.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Pass.h>
+#include <llvm/ADT/Optional.h>
+#include <llvm/ADT/SmallVector.h>
+#include <memory>
+
+namespace alioth {
+
+/**
+ * @class TracePass : 追踪遍
+ * @desc :
+ *  成对地插入在被追踪的llvm遍前后,前者记录开始时刻,后者产生追踪事件
+ *  追踪遍不修改任何内容,保留所有分析结果
+ */
+template<typename P, typename U>
+class TracePass : public P {
+    public:
+        static char ID;
+    private:
+        Pengine* mpengine;
+        string mname;
+        string mmodule;
+        shared_ptr<double> mbegin;
+        bool mend;
+
+    public:
+        TracePass( Pengine* pengine, const string& name, const string& module, shared_ptr<double> begin, bool end ):
+            P(ID),mpengine(pengine),mname(name),mmodule(module),mbegin(begin),mend(end) {}
+
+        StringRef getPassName()const override {
+            return "alioth trace";
+        }
+
+        void getAnalysisUsage( AnalysisUsage& au )const override {
+            au.setPreservesAll();
+        }
+
+        bool run( U& ) {
+            double wall, cpu;
+            long rss;
+            Pengine::now(wall,cpu,rss);
+            if( !mend ) *mbegin = wall;
+            else mpengine->commit((Pengine::event){mname,"pass",mmodule,(*mbegin-mpengine->epoch())*1e3,(wall-*mbegin)*1e3,Pengine::tid()});
+            return false;
+        }
+};
+template<typename P, typename U> char TracePass<P,U>::ID = 0;
+
+struct FunctionTracePass : public TracePass<FunctionPass,Function> {
+    using TracePass::TracePass;
+    bool runOnFunction( Function& f ) override { return run(f); }
+};
+
+struct ModuleTracePass : public TracePass<ModulePass,Module> {
+    using TracePass::TracePass;
+    bool runOnModule( Module& m ) override { return run(m); }
+};
+
+/**
+ * @class TracedPassManager : 被追踪的遍管理器
+ * @desc :
+ *  目标机器通过add方法向遍管理器添加遍,被追踪的遍管理器在函数遍和模块遍的前后插入追踪遍
+ *  其他种类的遍不被追踪
+ */
+class TracedPassManager : public legacy::PassManager {
+    private:
+        Pengine* mpengine;
+        string mmodule;
+
+    public:
+        TracedPassManager( Pengine* pengine, const string& module ):mpengine(pengine),mmodule(module) {}
+
+        void add( Pass* p ) override {
+            auto begin = make_shared<double>(0);
+            string name = p->getPassName().str();
+            switch( p->getPassKind() ) {
+                case PT_Function:
+                    legacy::PassManager::add(new FunctionTracePass(mpengine,name,mmodule,begin,false));
+                    legacy::PassManager::add(p);
+                    legacy::PassManager::add(new FunctionTracePass(mpengine,name,mmodule,begin,true));
+                    break;
+                case PT_Module:
+                    legacy::PassManager::add(new ModuleTracePass(mpengine,name,mmodule,begin,false));
+                    legacy::PassManager::add(p);
+                    legacy::PassManager::add(new ModuleTracePass(mpengine,name,mmodule,begin,true));
+                    break;
+                default:
+                    legacy::PassManager::add(p);
+                    break;
+            }
+        }
+};
+
+TargetMachine* Bengine::createTargetMachine( const string& triple ) {
+    TargetOptions opt;
+    std::string Error;
+    auto CPU = "generic";
+    auto Features = "";
+
+    auto target = TargetRegistry::lookupTarget(triple, Error);
+    if( !target ) return nullptr;
+    auto RM = Optional<Reloc::Model>();
+    return target->createTargetMachine( triple, CPU, Features, opt, RM);
+}
+
+bool Bengine::translate( Module& unit, TargetMachine& machine, Dengine::vfdm fd, Dengine& dengine, string* image, Pengine* pengine ) {
+    auto wfd = fd;
+    wfd.name += ".w";
+    SmallVector<char,0> buffer;
+    raw_svector_ostream obj(buffer);
+    raw_fd_ostream wdest = raw_fd_ostream(dengine.getOfd(wfd),true);
+    unique_ptr<legacy::PassManager> manager;
+    if( pengine and pengine->tracing() ) manager = make_unique<TracedPassManager>(pengine,unit.getModuleIdentifier());
+    else manager = make_unique<legacy::PassManager>();
+    auto& pass = *manager;
+
+    if( machine.addPassesToEmitFile(pass,obj,&wdest,TargetMachine::CGFT_ObjectFile) ) return false;
+    pass.run(unit);
+
+    raw_fd_ostream dest = raw_fd_ostream(dengine.getOfd(fd),true);
+    dest.write(buffer.data(),buffer.size());
+    dest.flush();
+    if( dest.has_error() ) return false;
+    if( image ) image->assign(buffer.data(),buffer.size());
+    return true;
+}
+
+}
+
+#endif
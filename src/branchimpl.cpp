@@ -6,6 +6,8 @@
 
 namespace alioth{
     
+BranchImpl::BranchImpl():implementation(cthing::BranchImpl) {}
+
 bool BranchImpl::is( cnode c ) const{
     return c == BRANCHIMPL or c == IMPLEMENTATION;
 }
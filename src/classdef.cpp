@@ -5,6 +5,10 @@
 
 namespace alioth {
 
+ClassDef::ClassDef():ClassDef(cthing::ClassDef) {}
+
+ClassDef::ClassDef( cthing c ):definition(c) {}
+
 bool ClassDef::is( cnode c ) const {
     return c == CLASSDEF or c == DEFINITION;
 }
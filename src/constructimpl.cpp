@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+ConstructImpl::ConstructImpl():implementation(cthing::ConstructImpl) {}
+
 bool ConstructImpl::is( cnode n ) const {
     return n == IMPLEMENTATION or n == CONSTRUCTIMPL;
 }
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+ConstructorImpl::ConstructorImpl():implementation(cthing::ConstructorImpl) {}
+
 bool ConstructorImpl::is( cnode c ) const {
     return c == IMPLEMENTATION or c == CONSTRUCTORIMPL;
 }
@@ -7,6 +7,9 @@
 #include <fcntl.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <iterator>
 
 namespace alioth {
 using namespace std;
@@ -30,6 +33,86 @@ bool Dengine::vfdm::operator!=(const vfdm& an) const {
     return !(an == *this);
 }
 
+Dengine::vmap::vmap():mdata(""),msize(0),mmapped(false),mgood(false) {
+
+}
+
+Dengine::vmap::vmap( vmap&& an ):mdata(""),msize(0),mmapped(false),mgood(false) {
+    *this = move(an);
+}
+
+Dengine::vmap::~vmap() {
+    if( mmapped ) munmap((void*)mdata,msize);
+}
+
+Dengine::vmap& Dengine::vmap::operator=( vmap&& an ) {
+    if( &an == this ) return *this;
+    if( mmapped ) munmap((void*)mdata,msize);
+    mmapped = an.mmapped;
+    mgood = an.mgood;
+    msize = an.msize;
+    mbuffer = move(an.mbuffer);
+    mdata = mmapped ? an.mdata : mbuffer.data();
+    an.mdata = "";
+    an.msize = 0;
+    an.mmapped = false;
+    an.mgood = false;
+    return *this;
+}
+
+bool Dengine::vmap::map( int fd ) {
+    if( fd < 0 ) return false;
+    struct stat st;
+    if( fstat(fd,&st) or !S_ISREG(st.st_mode) ) {
+        close(fd);
+        return false;
+    }
+    mgood = true;
+    if( st.st_size > 0 ) {
+        void* addr = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+        if( addr != MAP_FAILED ) {
+            madvise(addr,st.st_size,MADV_SEQUENTIAL);
+            mdata = (const char*)addr;
+            msize = st.st_size;
+            mmapped = true;
+        } else {
+            for( char buf[4096]; ; ) {
+                auto n = read(fd,buf,sizeof(buf));
+                if( n <= 0 ) {mgood = n == 0;break;}
+                mbuffer.append(buf,n);
+            }
+            mdata = mbuffer.data();
+            msize = mbuffer.size();
+        }
+    }
+    close(fd);
+    return mgood;
+}
+
+bool Dengine::vmap::load( istream& is ) {
+    mbuffer.assign((istreambuf_iterator<char>(is)),istreambuf_iterator<char>());
+    mdata = mbuffer.data();
+    msize = mbuffer.size();
+    mgood = !is.bad();
+    return mgood;
+}
+
+bool Dengine::vmap::good()const {
+    return mgood;
+}
+
+const char* Dengine::vmap::data()const {
+    return mdata;
+}
+
+size_t Dengine::vmap::size()const {
+    return msize;
+}
+
+string_view Dengine::vmap::view()const {
+    return string_view(mdata,msize);
+}
+
 Dengine::Dengine():
 mdirRoot("/usr/lib/alioth/"),
 mdirWork("."+string(dirdvs)),
@@ -53,7 +136,10 @@ Dengine::~Dengine(){
 
 unique_ptr<istream> Dengine::getIs( const string& fname, vspace space, const string& app )const {
     using namespace std;
-    if( midoc ) return midoc(fname,space,app);
+    if( midoc ) {
+        std::lock_guard<std::mutex> guard(mcustom);
+        return midoc(fname,space,app);
+    }
     string path = getPath(fname,space,app);
     unique_ptr<ifstream> is = make_unique<ifstream>(path);
     if( !is->good() ) return nullptr;
@@ -67,7 +153,10 @@ int Dengine::getIfd( const string& fname, vspace space, const string& app )const
 }
 unique_ptr<ostream> Dengine::getOs( const string& fname, vspace space, const string& app )const {
     using namespace std;
-    if( modoc ) return modoc(fname,space,app);
+    if( modoc ) {
+        std::lock_guard<std::mutex> guard(mcustom);
+        return modoc(fname,space,app);
+    }
     string path = getPath(fname,space,app);
     unique_ptr<ofstream> os = make_unique<ofstream>(path);
     if( !os->good() ) return nullptr;
@@ -120,6 +209,17 @@ bool Dengine::statFile( const string& fname, vspace space, const string& app, vf
     return true;
 }
 
+Dengine::vmap Dengine::mapFile( const string& fname, vspace space, const string& app )const {
+    vmap ret;
+    if( midoc ) {
+        std::lock_guard<std::mutex> guard(mcustom);
+        if( auto is = midoc(fname,space,app); is ) ret.load(*is);
+    } else {
+        ret.map(getIfd(fname,space,app));
+    }
+    return ret;
+}
+
 string Dengine::getPath( const string& docName, vspace space, const string& app )const {
     string st;
     vspace p = (vspace)(space & 0xFF00);
@@ -170,6 +270,10 @@ string Dengine::getPath( const vfdm& fdm )const {
     return getPath( fdm.name, fdm.space, fdm.app );
 }
 
+Dengine::vmap Dengine::mapFile( const vfdm& fdm )const {
+    return mapFile( fdm.name, fdm.space, fdm.app );
+}
+
 bool Dengine::setMethodGetIs( IstreamGetter methodIDoc ) {
     midoc = methodIDoc;
     return true;
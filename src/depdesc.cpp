@@ -9,6 +9,8 @@
 
 namespace alioth {
 
+depdesc::depdesc():node(cthing::depdesc) {}
+
 token depdesc::literal()const {
     if( alias.is(VT::iTHIS) ) return alias;
     else if( alias.is(VT::LABEL) ) return alias;
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+EnumDef::EnumDef():definition(cthing::EnumDef) {}
+
 bool EnumDef::is( cnode c ) const {
     return c == ENUMDEF or c == DEFINITION;
 }
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+eproto::eproto():thing(cthing::eproto) {}
+
 $eproto eproto::MakeUp( $scope scope, etype tele, $typeuc tdat, const token& fconst ) {
     if( !scope or !tdat ) return nullptr;
     $eproto ret = new eproto;
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+ExpressionImpl::ExpressionImpl():implementation(cthing::ExpressionImpl) {}
+
 bool ExpressionImpl::is( cnode c )const {
     return c == EXPRESSIONIMPL or c == IMPLEMENTATION;
 }
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+FlowCtrlImpl::FlowCtrlImpl():implementation(cthing::FlowCtrlImpl) {}
+
 bool FlowCtrlImpl::is( cnode c ) const {
     return c == CONTROLIMPL or c == IMPLEMENTATION;
 }
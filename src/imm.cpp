@@ -7,7 +7,8 @@
 
 namespace alioth {
 
-imm::imm( immt T, Value* V, anything P, agent<imm> H ):t(T),v(V),p(P),h(H){}
+imm::imm():thing(cthing::imm) {}
+imm::imm( immt T, Value* V, anything P, agent<imm> H ):thing(cthing::imm),t(T),v(V),p(P),h(H){}
 
 bool imm::is( immt arg ) const { return arg == t; }
 imm::immt imm::is()const{ return t; }
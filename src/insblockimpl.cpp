@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+InsBlockImpl::InsBlockImpl():implementation(cthing::InsBlockImpl) {}
+
 bool InsBlockImpl::is( cnode c ) const {
     return c == BLOCKIMPL or c == IMPLEMENTATION;
 }
@@ -3,7 +3,15 @@
 
 #include "jsonz.hpp"
 
-#include <map>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__x86_64__) or defined(__i386__)
+#include <immintrin.h>
+#define __alioth_simd__
+#endif
 
 
 static const char TAG_NULL   = 0;
@@ -17,52 +25,83 @@ static const char TAG_ARR    = 7;
 static const char END_OBJ    = 8;
 static const char END_ARR    = 9;
 
-using jarray = chainz<Jsonz>;
-using jobject = std::map<std::string,Jsonz>;
+static const char TAG_LONG   = 10;
 
-Jsonz::Jsonz( JType type ):mtype(type) {
-    switch( type ) {
-        case JArray:
-            mdata = new jarray;break;
-        case JBoolean:
-            *(bool*)&mdata = false;break;
-        case JInteger:
-            *(int*)&mdata = 0;break;
-        case JObject:
-            mdata = new jobject;break;
-        case JReal:
-            mdata = new double(0);break;
-        case JString:
-            mdata = new std::string;break;
-        default:
-            mdata = nullptr;
-    }
+/**
+ * @member MAGIC : 带索引的abon编码的文件头
+ */
+static const char MAGIC[8] = {'A','B','O','N',2,0,0,0};
+
+/**
+ * @member LONG : 堆上的长字符串的标记
+ */
+static const uint8_t LONG = 0xff;
+
+/**
+ * @member RESIDENT : 驻留在文档中的存储区的标记
+ */
+static const uint8_t RESIDENT = 0xfe;
+
+/**
+ * @member active : 当前线程上生效的文档
+ */
+static thread_local JsonzDocument* active = nullptr;
+
+struct Jsonz::member {
+    Jsonz key;
+    Jsonz value;
+};
+
+static_assert(sizeof(Jsonz) == 16, "Jsonz must fit in 16 bytes");
+
+/**
+ * @function capacity : 计算容器的容量
+ * @desc :
+ *  容器的容量是不小于元素个数的2的幂,最少为4,所以容量不需要单独记录
+ */
+static inline size_t capacity( size_t size ) {
+    size_t cap = 4;
+    while( cap < size ) cap <<= 1;
+    return cap;
+}
+
+Jsonz::Jsonz( JType type ) {
+    mint = 0;
+    msize = 0;
+    mlength = 0;
+    mtype = type;
 }
 
 Jsonz::Jsonz( const std::string& str ):Jsonz(JString) {
-    *(std::string*)mdata = str;
+    assign(str.data(),str.size());
 }
 
-Jsonz::Jsonz( const Jsonz& an ):mtype(an.mtype) {
+Jsonz::Jsonz( const Jsonz& an ):Jsonz(an.tell()) {
     switch( an.mtype ) {
-        case JArray:
-            mdata = new jarray(*(jarray*)an.mdata);break;
         case JBoolean:
         case JInteger:
-            mdata = an.mdata;break;
-        case JObject:
-            mdata = new jobject(*(jobject*)an.mdata);break;
         case JReal:
-            mdata = new double(*(double*)an.mdata);break;
-        case JString:
-            mdata = new std::string(*(std::string*)an.mdata);break;
-        default:
-            mdata = nullptr;
+            mint = an.mint;break;
+        case JString: {
+            auto v = an.view();
+            assign(v.data(),v.size());
+        } break;
+        case JArray:
+            reserve(an.msize);
+            for( uint32_t i = 0; i < an.msize; i++ ) new ((Jsonz*)mheap + i) Jsonz(((const Jsonz*)an.mheap)[i]);
+            msize = an.msize;
+            break;
+        case JObject:
+            reserve(an.msize);
+            for( uint32_t i = 0; i < an.msize; i++ ) new ((member*)mheap + i) member(((const member*)an.mheap)[i]);
+            msize = an.msize;
+            break;
+        default:break;
     }
 }
 
-Jsonz::Jsonz( Jsonz&& an ):mtype(an.mtype),mdata(an.mdata) {
-    an.mdata = nullptr;
+Jsonz::Jsonz( Jsonz&& an ) {
+    memcpy((void*)this,(const void*)&an,sizeof(Jsonz));
     an.mtype = JNull;
 }
 
@@ -72,534 +111,384 @@ Jsonz::~Jsonz() {
 
 void Jsonz::clear() {
     switch( mtype ) {
+        case JString:
+            if( mlength == LONG ) free(mheap);
+            break;
         case JArray:
-            delete (jarray*)mdata;break;
+            for( uint32_t i = 0; i < msize; i++ ) ((Jsonz*)mheap)[i].~Jsonz();
+            if( mlength != RESIDENT ) free(mheap);
+            break;
         case JObject:
-            delete (jobject*)mdata;break;
-        case JReal:
-            delete (double*)mdata;break;
-        case JString:
-            delete (std::string*)mdata;break;
+            for( uint32_t i = 0; i < msize; i++ ) ((member*)mheap)[i].~member();
+            if( mlength != RESIDENT ) free(mheap);
+            break;
         default:break;
     }
-    mdata = nullptr;
+    mint = 0;
+    msize = 0;
+    mlength = 0;
     mtype = JNull;
 }
 
-Jsonz Jsonz::fromJsonStream( std::istream& is, int* endp ) {
-    Jsonz ret;
-    int pre;    //preview
-    int state = 1;
-    std::string u;
+std::string_view Jsonz::view()const {
+    if( mtype != JString ) return std::string_view();
+    if( mlength >= RESIDENT ) return std::string_view((const char*)mheap,msize);
+    return std::string_view(mshort,mlength);
+}
+
+void Jsonz::assign( const char* data, size_t size ) {
+    clear();
+    mtype = JString;
+    if( size <= sizeof(mshort) ) {
+        memcpy(mshort,data,size);
+        mlength = size;
+    } else {
+        mheap = active ? active->allocate(size) : malloc(size);
+        memcpy(mheap,data,size);
+        msize = size;
+        mlength = active ? RESIDENT : LONG;
+    }
+}
 
-    auto u2u = [&]() {
-        char h,l;
-                        
-        if( u[0] >= 'a' and u[0] <= 'f' ) h = u[0] - 'a' + 0x0a;
-        else h = u[0] - '0';
-        h <<= 4;
+/**
+ * 首次分配的存储区来自生效的文档,驻留的存储区在增长时从生效的文档或堆上重新分配
+ * 堆上的存储区总是在堆上增长,所以启用文档不会影响已经存在的值
+ */
+void Jsonz::reserve( size_t size ) {
+    size_t unit = mtype == JObject ? sizeof(member) : sizeof(Jsonz);
+    size_t bytes = capacity(size) * unit;
+    if( mheap and capacity(size) <= capacity(msize) ) return;
+    if( mheap and mlength != RESIDENT ) {
+        mheap = realloc(mheap,bytes);
+    } else if( active ) {
+        auto p = active->allocate(bytes);
+        if( msize ) memcpy(p,mheap,msize * unit);
+        mheap = p;
+        mlength = RESIDENT;
+    } else {
+        auto p = malloc(bytes);
+        if( msize ) memcpy(p,mheap,msize * unit);
+        mheap = p;
+        mlength = 0;
+    }
+}
 
-        if( u[1] >= 'a' and u[0] <= 'f' ) h |= u[1] - 'a' + 0x0a;
-        else h |= u[1] - '0';
+Jsonz* Jsonz::slot( size_t index ) {
+    reserve(msize + 1);
+    auto items = (Jsonz*)mheap;
+    memmove((void*)(items + index + 1),(const void*)(items + index),(msize - index) * sizeof(Jsonz));
+    msize += 1;
+    return items + index;
+}
 
-        if( u[2] >= 'a' and u[2] <= 'f' ) l = u[2] - 'a' + 0x0a;
-        else l = u[2] - '0';
-        l <<= 4;
+Jsonz::member* Jsonz::locate( std::string_view key )const {
+    auto members = (member*)mheap;
+    if( msize and members[msize-1].key.view() < key ) return members + msize;
+    return std::lower_bound(members,members + msize,key,[]( const member& m, std::string_view k ) {
+        return m.key.view() < k;
+    });
+}
+
+/**
+ * @function blank : 判断空白字符
+ */
+static inline bool blank( int c ) {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\r';
+}
 
-        if( u[3] >= 'a' and u[3] <= 'f' ) l |= u[3] - 'a' + 0x0a;
-        else l |= u[3] - '0';
+/**
+ * @function hex : 解析十六进制数字
+ * @return int : 数值,若不是十六进制数字,返回-1
+ */
+static inline int hex( char c ) {
+    if( c >= '0' and c <= '9' ) return c - '0';
+    if( c >= 'a' and c <= 'f' ) return c - 'a' + 0x0a;
+    if( c >= 'A' and c <= 'F' ) return c - 'A' + 0x0a;
+    return -1;
+}
+
+bool Jsonz::parse( const char* data, size_t size, handler& h, size_t* used ) {
+    const char* p = data;
+    const char* const e = data + size;
+    std::string scratch;
+    std::vector<char> nest;
+    std::string_view view;
+    enum { VALUE, KEY, AFTER } state = VALUE;
 
-        *(std::string*)ret.mdata += l;
-        if( h != 0 ) *(std::string*)ret.mdata += h;
+    auto skip = [&]() {
+        while( p < e and blank(*p) ) p++;
     };
 
-    for( pre = is.peek(); state > 0; pre = is.peek() ) 
-        switch( pre ) {
-            case '\0':case EOF:
-                if( state == 1 ) {
-                    state = -1;
-                } else if( state == 16 ) {
-                    state = 0;
-                    ret.mtype = JInteger;
-                    *(int*)&ret.mdata = strtol(u.data(),nullptr,10);
-                } else if( state == 18 or state == 21 ) {
-                    state = 0;
-                    ret.mtype = JReal;
-                    ret.mdata = new double(strtod(u.data(),nullptr));
-                } else {
-                    state = -1;
-                } break;
-            case ' ':case '\t':case '\n':case '\r':
-                if( state == 1 ) {
-                    is.get();
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 16 ) {
-                    state = 0;
-                    ret.mtype = JInteger;
-                    *(int*)&ret.mdata = strtol(u.data(),nullptr,10);
-                } else if( state == 18 or state == 21 ) {
-                    state = 0;
-                    ret.mtype = JReal;
-                    ret.mdata = new double(strtod(u.data(),nullptr));
-                } else if( state == 22 or state == 23 or state == 24 or state == 25 or state == 26 ) {
-                    is.get();
-                } else {
-                    state = -1;
-                } break;
-            case '\"':
-                if( state == 1 ) {
-                    is.get();
-                    state = 2;
-                    ret.mtype = JString;
-                    ret.mdata = new std::string();
-                } else if( state == 2 ) {
-                    is.get();
-                    state = 0;
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 22 ) {
-                    Jsonz k = fromJsonStream(is);
-                    if( !k.is(JString) ) state = -1;
-                    else { u = (std::string)k;state = 23;}
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case '\\':
-                if( state == 2 ) {
-                    is.get();
-                    state = 3;
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += is.get();
-                } else {
-                    state = -1;
-                } break;
-            case 'a':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += '\a';
-                    is.get();
-                } else if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else if( state == 8 ) {
-                    is.get();
-                    state = 9;
-                } else {
-                    state = -1;
-                } break;
-            case 'b':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += '\b';
-                    is.get();
-                } else if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case 'c':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case 'd':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else  if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case 'e':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += '\e';
-                    is.get();
-                } else if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else if( state == 7 ) {
-                    is.get();
-                    *(bool*)&ret.mdata = true;
-                    state = 0;
-                } else if( state == 11 ) {
-                    is.get();
-                    *(bool*)&ret.mdata = false;
-                    state = 0;
-                } else if( state == 16 or state == 18 ) {
-                    u += is.get();
-                    state = 19;
-                } else {
-                    state = -1;
-                } break;
-            case 'E':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 16 or state == 18 ) {
-                    u += is.get();
-                    state = 19;
-                } else {
-                    state = -1;
-                }break;
-            case 'f':
-                if( state == 1 ) {
-                    is.get();
-                    state = 8;
-                    ret.mtype = JBoolean;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case 'l':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 9 ) {
-                    is.get();
-                    state = 10;
-                } else if( state == 13 ) {
-                    is.get();
-                    state = 14;
-                } else if( state == 14 ) {
-                    is.get();
-                    state = 0;
-                    ret.mdata = nullptr;
-                } else {
-                    state = -1;
-                } break;
-            case 'n':
-                if( state == 1 ) {
-                    is.get();
-                    state = 12;
-                    ret.mtype = JNull;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += '\n';
-                    is.get();
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case 'o':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else {
-                    state = -1;
-                } break;
-            case 'r':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    is.get();
-                    state = 2;
-                    *(std::string*)ret.mdata += '\r';
-                } else if( state == 5 ) {
-                    is.get();
-                    state = 6;
-                } else {
-                    state = -1;
-                } break;
-            case 's':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 10 ) {
-                    is.get();
-                    state = 11;
-                } else {
-                    state = -1;
-                } break;
-            case 't':
-                if( state == 1 ) {
-                    is.get();
-                    state = 5;
-                    ret.mtype = JBoolean;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    state = 2;
-                    *(std::string*)ret.mdata += '\t';
-                    is.get();
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case 'u':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 3 ) {
-                    is.get();
-                    state = 4;
-                    u.clear();
-                } else if( state == 6 ) {
-                    is.get();
-                    state = 7;
-                } else if( state == 12 ) {
-                    is.get();
-                    state = 13;
-                } else {
-                    state = -1;
-                } break;
-            case '0' ... '9':
-                if( state == 1 ) {
-                    u = is.get();
-                    state = 16;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 4 ) {
-                    u += is.get();
-                    if( u.size() == 4 ) {
-                        u2u();
-                        state = 2;
-                    }
-                } else if( state == 15 ) {
-                    u += is.get();
-                    state = 16;
-                } else if( state == 16 ) {
-                    u += is.get();
-                } else if( state == 17 ) {
-                    u += is.get();
-                    state = 18;
-                } else if( state == 18 ) {
-                    u += is.get();
-                } else if( state == 19 or state == 20 ) {
-                    u += is.get();
-                    state = 21;
-                } else if( state == 21 ) {
-                    u += is.get();
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case '.':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 16 ) {
-                    u += is.get();
-                    state = 17;
-                } else {
-                    state = -1;
-                } break;
-            case '-':
-                if( state == 1 ) {
-                    u = is.get();
-                    state = 15;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 19 ) {
-                    u += is.get();
-                    state = 20;
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                } break;
-            case '+':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 19 ) {
-                    u += is.get();
-                    state = 20;
-                } else {
-                    state = -1;
+    /** 扫描字符串,p指向起始的引号,扫描结束后p指向结束的引号之后 */
+    auto scan = [&]() -> bool {
+        const char* b = ++p;
+        while( p < e and *p != '\"' and *p != '\\' ) p++;
+        if( p >= e ) return false;
+        if( *p == '\"' ) {
+            view = std::string_view(b,p-b);
+            p++;
+            return true;
+        }
+        scratch.assign(b,p);
+        while( p < e and *p != '\"' ) {
+            if( *p != '\\' ) {
+                scratch += *p++;
+                continue;
+            }
+            if( ++p >= e ) return false;
+            switch( *p++ ) {
+                case '\"': scratch += '\"';break;
+                case '\\': scratch += '\\';break;
+                case '/': scratch += '/';break;
+                case 'a': scratch += '\a';break;
+                case 'b': scratch += '\b';break;
+                case 'e': scratch += '\e';break;
+                case 'f': scratch += '\f';break;
+                case 'n': scratch += '\n';break;
+                case 'r': scratch += '\r';break;
+                case 't': scratch += '\t';break;
+                case 'u': {
+                    if( e - p < 4 ) return false;
+                    int d[4];
+                    for( int i = 0; i < 4; i++ ) if( (d[i] = hex(p[i])) < 0 ) return false;
+                    char hi = d[0] << 4 | d[1];
+                    char lo = d[2] << 4 | d[3];
+                    scratch += lo;
+                    if( hi != 0 ) scratch += hi;
+                    p += 4;
                 } break;
+                default: return false;
+            }
+        }
+        if( p >= e ) return false;
+        p++;
+        view = scratch;
+        return true;
+    };
+
+    /** 扫描数字,没有小数部分和指数部分的数字是整数 */
+    auto number = [&]() -> bool {
+        const char* b = p;
+        bool integral = true;
+        auto digits = [&]() {
+            const char* d = p;
+            while( p < e and *p >= '0' and *p <= '9' ) p++;
+            return p > d;
+        };
+        if( p < e and *p == '-' ) p++;
+        if( !digits() ) return false;
+        if( p < e and *p == '.' ) {
+            p++;
+            integral = false;
+            if( !digits() ) return false;
+        }
+        if( p < e and (*p == 'e' or *p == 'E') ) {
+            p++;
+            integral = false;
+            if( p < e and (*p == '+' or *p == '-') ) p++;
+            if( !digits() ) return false;
+        }
+        char buf[64];
+        std::string big;
+        const char* num = buf;
+        if( size_t(p - b) < sizeof(buf) ) {
+            std::copy(b,p,buf);
+            buf[p-b] = '\0';
+        } else {
+            big.assign(b,p);
+            num = big.data();
+        }
+        if( integral ) return h.integer(strtoll(num,nullptr,10));
+        else return h.real(strtod(num,nullptr));
+    };
+
+    auto literal = [&]( const char* word, size_t len ) {
+        if( size_t(e - p) < len or memcmp(p,word,len) != 0 ) return false;
+        p += len;
+        return true;
+    };
+
+    auto fail = [&]() {
+        if( used ) *used = p - data;
+        return false;
+    };
+
+    while( true ) {
+        skip();
+        if( state == AFTER ) {
+            if( nest.empty() ) break;
+            if( p >= e ) return fail();
+            if( *p == ',' ) {
+                p++;
+                state = nest.back() == '{' ? KEY : VALUE;
+            } else if( *p == '}' and nest.back() == '{' ) {
+                p++;
+                nest.pop_back();
+                if( !h.closeObject() ) return fail();
+            } else if( *p == ']' and nest.back() == '[' ) {
+                p++;
+                nest.pop_back();
+                if( !h.closeArray() ) return fail();
+            } else {
+                return fail();
+            }
+            continue;
+        }
+
+        if( p >= e ) return fail();
+        if( state == KEY ) {
+            if( *p != '\"' or !scan() or !h.key(view) ) return fail();
+            skip();
+            if( p >= e or *p != ':' ) return fail();
+            p++;
+            state = VALUE;
+            continue;
+        }
+
+        state = AFTER;
+        switch( *p ) {
             case '{':
-                if( state == 1 ) {
-                    is.get();
-                    state = 22;
-                    ret.mtype = JObject;
-                    ret.mdata = new jobject;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                }break;
-            case '}':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 16 ) {
-                    state = 0;
-                    ret.mtype = JInteger;
-                    *(int*)&ret.mdata = strtol(u.data(),nullptr,10);
-                } else if( state == 18 or state == 21 ) {
-                    state = 0;
-                    ret.mtype = JReal;
-                    ret.mdata = new double(strtod(u.data(),nullptr));
-                } else if( state == 22 or state == 24 ) {
-                    is.get();
-                    state = 0;
+                p++;
+                if( !h.openObject() ) return fail();
+                skip();
+                if( p < e and *p == '}' ) {
+                    p++;
+                    if( !h.closeObject() ) return fail();
                 } else {
-                    state = -1;
+                    nest.push_back('{');
+                    state = KEY;
                 } break;
             case '[':
-                if( state == 1 ) {
-                    is.get();
-                    state = 25;
-                    ret.mtype = JArray;
-                    ret.mdata = new jarray;
-                } else if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 25 ) {
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
-                } else {
-                    state = -1;
-                }break;
-            case ']':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 16 ) {
-                    state = 0;
-                    ret.mtype = JInteger;
-                    *(int*)&ret.mdata = strtol(u.data(),nullptr,10);
-                } else if( state == 18 or state == 21 ) {
-                    state = 0;
-                    ret.mtype = JReal;
-                    ret.mdata = new double(strtod(u.data(),nullptr));
-                } else if( state == 25 or state == 26 ) {
-                    is.get();
-                    state = 0;
-                } else {
-                    state = -1;
-                } break;
-            case ',':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 16 ) {
-                    state = 0;
-                    ret.mtype = JInteger;
-                    *(int*)&ret.mdata = strtol(u.data(),nullptr,10);
-                } else if( state == 18 or state == 21 ) {
-                    state = 0;
-                    ret.mtype = JReal;
-                    ret.mdata = new double(strtod(u.data(),nullptr));
-                } else if( state == 24 ) {
-                    is.get();
-                    Jsonz k = fromJsonStream(is);
-                    if( !k.is(JString) ) {
-                        state = -1;
-                    } else {
-                        u = (std::string)k;
-                        state = 23;
-                    }
-                } else if( state == 26 ) {
-                    is.get();
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret.insert( std::move(v), -1 );
-                        state = 26;
-                    }
+                p++;
+                if( !h.openArray() ) return fail();
+                skip();
+                if( p < e and *p == ']' ) {
+                    p++;
+                    if( !h.closeArray() ) return fail();
                 } else {
-                    state = -1;
+                    nest.push_back('[');
+                    state = VALUE;
                 } break;
-            case ':':
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else if( state == 23 ) {
-                    is.get();
-                    Jsonz v = fromJsonStream(is,&state);
-                    if( state == 0 ) {
-                        ret[u] = std::move(v);
-                        state = 24;
-                    }
-                } else {
-                    state = -1;
-                }break;
+            case '\"':
+                if( !scan() or !h.text(view) ) return fail();
+                break;
+            case 't':
+                if( !literal("true",4) or !h.boolean(true) ) return fail();
+                break;
+            case 'f':
+                if( !literal("false",5) or !h.boolean(false) ) return fail();
+                break;
+            case 'n':
+                if( !literal("null",4) or !h.null() ) return fail();
+                break;
             default:
-                if( state == 2 ) {
-                    *(std::string*)ret.mdata += is.get();
-                } else {
-                    state = -1;
-                }break;
+                if( !number() ) return fail();
+                break;
         }
+    }
 
-    if( endp ) *endp = state;
+    if( used ) *used = p - data;
+    return true;
+}
 
-    if( state != 0 )
-        return Jsonz(JNull);
-    return ret;
+/**
+ * @struct builder : 文档树构造器
+ * @desc :
+ *  在事件之上构造文档树,每个未闭合的容器占据一帧
+ *  容器闭合时被移入上一帧的容器,所以不需要持有指向容器内部的指针
+ */
+struct builder : public Jsonz::handler {
+    struct frame {
+        Jsonz       value;
+        std::string key;
+    };
+    std::vector<frame> frames;
+    Jsonz root;
+
+    bool put( Jsonz&& v ) {
+        if( frames.empty() ) root = std::move(v);
+        else if( auto& f = frames.back(); f.value.is(JArray) ) f.value.insert(std::move(v),-1);
+        else f.value[f.key] = std::move(v);
+        return true;
+    }
+
+    bool null()override {return put(Jsonz(JNull));}
+    bool boolean( bool v )override {Jsonz j;j = v;return put(std::move(j));}
+    bool integer( long long v )override {Jsonz j;j = v;return put(std::move(j));}
+    bool real( double v )override {Jsonz j;j = v;return put(std::move(j));}
+    bool text( std::string_view v )override {Jsonz j;j = v;return put(std::move(j));}
+    bool key( std::string_view k )override {frames.back().key.assign(k.data(),k.size());return true;}
+    bool openObject()override {frames.push_back((frame){Jsonz(JObject),""});return true;}
+    bool openArray()override {frames.push_back((frame){Jsonz(JArray),""});return true;}
+    bool closeObject()override {return close();}
+    bool closeArray()override {return close();}
+
+    bool close() {
+        Jsonz v = std::move(frames.back().value);
+        frames.pop_back();
+        return put(std::move(v));
+    }
+};
+
+Jsonz Jsonz::fromJson( const char* data, size_t size, size_t* used ) {
+    builder b;
+    if( !parse(data,size,b,used) ) return Jsonz(JNull);
+    return std::move(b.root);
+}
+
+Jsonz Jsonz::fromJsonStream( std::istream& is, int* endp ) {
+    std::string buf;
+    int depth = 0;
+    bool quote = false;
+    bool escape = false;
+    auto sb = is.rdbuf();
+    if( endp ) *endp = -1;
+    if( !is or !sb ) return Jsonz(JNull);
+
+    /**
+     * 从流中截取恰好一个json值,不读取值之后的内容
+     * 容器在括号配平时结束,字符串在结束的引号处结束,其余的值在分隔符处结束
+     */
+    int c;
+    while( (c = sb->sgetc()) != EOF and blank(c) ) sb->sbumpc();
+    while( (c = sb->sgetc()) != EOF ) {
+        if( quote ) {
+            buf += (char)sb->sbumpc();
+            if( escape ) escape = false;
+            else if( c == '\\' ) escape = true;
+            else if( c == '\"' ) {
+                quote = false;
+                if( depth == 0 ) break;
+            }
+            continue;
+        }
+        if( depth == 0 and !buf.empty() and (blank(c) or c == ',' or c == ':' or c == ']' or c == '}') ) break;
+        buf += (char)sb->sbumpc();
+        if( c == '\"' ) quote = true;
+        else if( c == '{' or c == '[' ) depth += 1;
+        else if( (c == '}' or c == ']') and --depth <= 0 ) break;
+    }
+    if( c == EOF ) is.setstate(std::ios::eofbit);
+
+    size_t used = 0;
+    builder b;
+    if( !parse(buf.data(),buf.size(),b,&used) or used != buf.size() ) return Jsonz(JNull);
+    if( endp ) *endp = 0;
+    return std::move(b.root);
 }
 
 Jsonz Jsonz::fromAbonStream( std::istream& is, int* endp ) {
     Jsonz ret;
     int state = 1;
+
+    /** 按照小端序读取定长的整数 */
+    auto fixed = [&]( size_t bytes, uint64_t& v ) {
+        v = 0;
+        for( size_t i = 0; i < bytes; i++ )
+            if( is.peek() == EOF ) return false;
+            else v |= (uint64_t)(is.get()&0x0FF) << (i<<3);
+        return true;
+    };
     
     switch( is.peek() ) {
         case TAG_NULL:
@@ -618,63 +507,65 @@ Jsonz Jsonz::fromAbonStream( std::istream& is, int* endp ) {
             break;
         case TAG_INT: {
             is.get();
-            ret.mtype = JInteger;
-            ret.mdata = 0x00;
-            for( size_t i = 0; i < sizeof(int); i++ )
-                if( is.peek() == EOF ) {
-                    state = -1;
-                    break;
-                } else {
-                    *(int*)&ret.mdata |= (is.get()&0x0FF) << (i<<3);
-                }
-            if( state > 0 )
+            uint64_t v;
+            if( fixed(sizeof(int),v) ) {
+                ret = (int)(uint32_t)v;
                 state = 0;
+            } else {
+                state = -1;
+            }
+        } break;
+        case TAG_LONG: {
+            is.get();
+            uint64_t v;
+            if( fixed(sizeof(long long),v) ) {
+                ret = (long long)v;
+                state = 0;
+            } else {
+                state = -1;
+            }
         } break;
         case TAG_REAL: {
             is.get();
-            ret.mtype = JReal;
-            ret.mdata = new double;
-            for( size_t i = 0; i < sizeof(double); i++ )
-                if( is.peek() == EOF ) {
-                    state = -1;
-                    break;
-                } else {
-                    *(int*)ret.mdata |= (is.get()&0x0FF) << (i<<3);
-                }
-            if( state > 0 )
+            uint64_t v;
+            if( fixed(sizeof(double),v) ) {
+                double d;
+                memcpy(&d,&v,sizeof(d));
+                ret = d;
                 state = 0;
+            } else {
+                state = -1;
+            }
         } break;
         case TAG_STR: {
             is.get();
-            ret.mtype = JString;
-            ret.mdata = new std::string;
+            std::string str;
             while( is.peek() != '\0' )
                 if( is.peek() == EOF ) {
                     state = -1;
                     break;
                 } else {
-                    *(std::string*)ret.mdata += is.get();
+                    str += is.get();
                 }
             is.get();
+            ret = str;
             if( state > 0 )
                 state = 0;
         } break;
         case TAG_ARR: {
             is.get();
-            ret.mtype = JArray;
-            ret.mdata = new jarray;
+            ret = Jsonz(JArray);
             while( is.peek() != END_ARR ) {
                 Jsonz v = fromAbonStream(is,&state);
                 if( state != 0 ) break;
-                ((jarray*)ret.mdata)->push(std::move(v));
+                ret.insert(std::move(v),-1);
             }
             if( state == 0 )
                 is.get();
         } break;
         case TAG_OBJ: {
             is.get();
-            ret.mtype = JObject;
-            ret.mdata = new jobject;
+            ret = Jsonz(JObject);
             while( is.peek() != END_OBJ ) {
                 Jsonz k = fromAbonStream(is,&state);
                 if( !k.is(JString) ) {
@@ -683,7 +574,7 @@ Jsonz Jsonz::fromAbonStream( std::istream& is, int* endp ) {
                 }
                 Jsonz v = fromAbonStream(is,&state);
                 if( state != 0 ) break;
-                (*(jobject*)ret.mdata)[k] = std::move(v);
+                ret[k] = std::move(v);
             }
             if( state == 0 )
                 is.get();
@@ -696,277 +587,807 @@ Jsonz Jsonz::fromAbonStream( std::istream& is, int* endp ) {
 }
 
 JType Jsonz::tell()const {
-    return mtype;
+    return (JType)mtype;
 }
 bool Jsonz::is( JType type )const {
     return mtype == type;
 }
 
 Jsonz::operator int()const {
-    if( mtype == JInteger ) return *(const int*)&mdata;
+    if( mtype == JInteger ) return (int)mint;
+    return 0;
+}
+Jsonz::operator long long()const {
+    if( mtype == JInteger ) return mint;
     return 0;
 }
 Jsonz::operator double()const {
-    if( mtype == JReal ) return *(const double*)mdata;
+    if( mtype == JReal ) return mreal;
     return 0;
 }
 Jsonz::operator bool()const {
-    if( mtype == JBoolean ) return *(const bool*)&mdata;
+    if( mtype == JBoolean ) return mbool;
     return false;
 }
 Jsonz::operator std::string()const {
-    if( mtype == JString ) return *(const std::string*)mdata;
-    else return "";
+    return std::string(view());
 }
 
 Jsonz& Jsonz::operator=(const Jsonz& an ) {
     Jsonz n(an);
-    clear();
-    mtype = n.mtype;
-    mdata = n.mdata;
-    n.mtype = JNull;
-    n.mdata = nullptr;
-    return *this;
+    return *this = std::move(n);
 }
 Jsonz& Jsonz::operator=(Jsonz&& an ) {
-    JType nt = an.mtype;
-    void* nd = an.mdata;
+    if( &an == this ) return *this;
+    alignas(Jsonz) char bytes[sizeof(Jsonz)];
+    memcpy(bytes,(const void*)&an,sizeof(Jsonz));
     an.mtype = JNull;
-    an.mdata = nullptr;
     clear();
-    mtype = nt;
-    mdata = nd;
+    memcpy((void*)this,bytes,sizeof(Jsonz));
     return *this;
 }
 Jsonz& Jsonz::operator=(bool v) {
     clear();
     mtype = JBoolean;
-    *(bool*)&mdata = v;
+    mbool = v;
     return *this;
 }
 Jsonz& Jsonz::operator=(int v) {
+    return *this = (long long)v;
+}
+Jsonz& Jsonz::operator=(long long v) {
     clear();
     mtype = JInteger;
-    *(int*)&mdata = v;
+    mint = v;
     return *this;
 }
 Jsonz& Jsonz::operator=(double v) {
     clear();
     mtype = JReal;
-    mdata = new double(v);
+    mreal = v;
     return *this;
 }
 Jsonz& Jsonz::operator=(const std::string& v) {
-    clear();
-    mtype = JString;
-    mdata = new std::string(v);
+    assign(v.data(),v.size());
     return *this;
 }
 Jsonz& Jsonz::operator=(const char* v ) {
-    clear();
-    mtype = JString;
-    mdata = new std::string(v);
+    assign(v,strlen(v));
+    return *this;
+}
+Jsonz& Jsonz::operator=(std::string_view v ) {
+    assign(v.data(),v.size());
     return *this;
 }
 
 bool Jsonz::insert( const Jsonz& v, int index ) {
     if( mtype != JArray ) return false;
-    if( index < 0 ) index = count() + 1 + index;
-    if( index < 0 ) {
-        while( index++ != 0 ) (*(jarray*)mdata).insert(Jsonz(JNull),0);
-        (*(jarray*)mdata).insert(v,0);
-    } else {
-        while( (long long)count() < index ) (*(jarray*)mdata).insert(Jsonz(JNull),-1);
-        (*(jarray*)mdata).insert(v,index);
-    }
-    return true;
+    return insert(Jsonz(v),index);
 }
 bool Jsonz::insert( Jsonz&& v, int index ) {
     if( mtype != JArray ) return false;
     if( index < 0 ) index = count() + 1 + index;
     if( index < 0 ) {
-        while( index++ != 0 ) (*(jarray*)mdata).insert(Jsonz(JNull),0);
-        (*(jarray*)mdata).insert(v,0);
+        while( index++ != 0 ) new (slot(0)) Jsonz(JNull);
+        new (slot(0)) Jsonz(std::move(v));
     } else {
-        while( (long long)count() < index ) (*(jarray*)mdata).insert(Jsonz(JNull),-1);
-        (*(jarray*)mdata).insert(std::move(v),index);
+        while( (long long)count() < index ) new (slot(msize)) Jsonz(JNull);
+        new (slot(index)) Jsonz(std::move(v));
     }
     return true;
 }
 size_t Jsonz::count() const {
-    if( mtype == JArray ) return ((const jarray*)mdata)->size();
-    else if( mtype == JObject ) return ((const jobject*)mdata)->size();
+    if( mtype == JArray or mtype == JObject ) return msize;
     return 0;
 }
 
 size_t Jsonz::count( const std::string& key ) const {
     if( mtype != JObject ) return 0;
-    return ((const jobject*)mdata)->count(key);
+    auto m = locate(key);
+    return m != (member*)mheap + msize and m->key.view() == key;
 }
 Jsonz& Jsonz::operator[](const std::string& key) {
     if( mtype != JObject ) return *(Jsonz*)0x0;
-    return (*(jobject*)mdata)[key];
+    auto m = locate(key);
+    if( m != (member*)mheap + msize and m->key.view() == key ) return m->value;
+    size_t index = m - (member*)mheap;
+    reserve(msize + 1);
+    m = (member*)mheap + index;
+    memmove((void*)(m + 1),(const void*)m,(msize - index) * sizeof(member));
+    msize += 1;
+    return (new (m) member{Jsonz(key),Jsonz(JNull)})->value;
 }
 const Jsonz& Jsonz::at(const std::string& key)const {
-    if( mtype == JObject and count(key) )
-        return (*(const jobject*)mdata).at(key);
-    else
-        return *(const Jsonz*)0x0;
+    if( mtype != JObject ) return *(const Jsonz*)0x0;
+    auto m = locate(key);
+    if( m != (member*)mheap + msize and m->key.view() == key ) return m->value;
+    return *(const Jsonz*)0x0;
 }
 Jsonz& Jsonz::operator[]( int index ) {
     if( mtype != JArray ) return *(Jsonz*)0x0;
-    jarray& arr = *(jarray*)mdata;
-    if( index >= arr.size() or index < -arr.size() ) insert(Jsonz(JNull),index);
-    return arr[index];
+    if( index >= (long long)msize or index < -(long long)msize ) insert(Jsonz(JNull),index);
+    if( index < 0 ) index += msize;
+    return ((Jsonz*)mheap)[index];
 }
 const Jsonz& Jsonz::at( int index )const {
-    if( mtype != JArray ) return *(Jsonz*)0x0;
-    const jarray& arr = *(const jarray*)mdata;
-    return arr[index];
+    if( mtype != JArray ) return *(const Jsonz*)0x0;
+    if( index < 0 ) index += msize;
+    if( index < 0 or index >= (long long)msize ) return *(const Jsonz*)0x0;
+    return ((const Jsonz*)mheap)[index];
 }
 
 int Jsonz::foreach( std::function<bool(Jsonz&)> fun ) {
     if( mtype != JArray ) return -1;
     int i = 0;
-    for( auto& v : *(jarray*)mdata ) 
-        if( !fun(v) ) break;
+    for( uint32_t n = 0; n < msize; n++ ) 
+        if( !fun(((Jsonz*)mheap)[n]) ) break;
         else i += 1;
     return i;
 }
 int Jsonz::foreach( std::function<bool(const Jsonz&)> fun )const {
     if( mtype != JArray ) return -1;
     int i = 0;
-    for( auto& v : *(const jarray*)mdata ) 
-        if( !fun(v) ) break;
+    for( uint32_t n = 0; n < msize; n++ ) 
+        if( !fun(((const Jsonz*)mheap)[n]) ) break;
         else i += 1;
     return i;
 }
 int Jsonz::foreach( std::function<bool(const std::string&,Jsonz&)> fun ) {
     if( mtype != JObject ) return -1;
     int i = 0;
-    for( auto& p : *(jobject*)mdata ) 
-        if( !fun(p.first,p.second) ) break;
+    for( uint32_t n = 0; n < msize; n++ ) 
+        if( auto& m = ((member*)mheap)[n]; !fun((std::string)m.key,m.value) ) break;
         else i += 1;
     return i;
 }
 int Jsonz::foreach( std::function<bool(const std::string&,const Jsonz&)> fun )const {
     if( mtype != JObject ) return -1;
     int i = 0;
-    for( auto& p : *(const jobject*)mdata ) 
-        if( !fun(p.first,p.second) ) break;
+    for( uint32_t n = 0; n < msize; n++ ) 
+        if( auto& m = ((const member*)mheap)[n]; !fun((std::string)m.key,m.value) ) break;
         else i += 1;
     return i;
 }
 
 bool Jsonz::drop( int index ) {
-    if( mtype == JArray )
-        return ((jarray*)mdata)->remove(index);
-    return false;
+    if( mtype != JArray ) return false;
+    if( index < 0 ) index += msize;
+    if( index < 0 or index >= (long long)msize ) return false;
+    auto items = (Jsonz*)mheap;
+    items[index].~Jsonz();
+    memmove((void*)(items + index),(const void*)(items + index + 1),(msize - index - 1) * sizeof(Jsonz));
+    msize -= 1;
+    return true;
 }
 bool Jsonz::drop( const std::string& key ) {
-    if( mtype == JObject )
-        return ((jobject*)mdata)->erase(key) > 0;
-    return false;
+    if( mtype != JObject ) return false;
+    auto m = locate(key);
+    auto e = (member*)mheap + msize;
+    if( m == e or m->key.view() != key ) return false;
+    m->~member();
+    memmove((void*)m,(const void*)(m + 1),(e - m - 1) * sizeof(member));
+    msize -= 1;
+    return true;
 }
 
-std::string Jsonz::toJson() const {
-    std::string ret;
-    switch( mtype ) {
-        case JNull : ret = "null";break;
-        case JBoolean : ret = (*(const bool*)&mdata)?"true":"false";break;
-        case JInteger: ret = std::to_string(*(const int*)&mdata);break;
-        case JReal: ret = std::to_string(*(const double*)mdata);break;
-        case JString: {
-            ret = "\"";
-            const std::string& v = *(const std::string*)mdata;
-            for( auto& c : v ) {
-                switch( c ) {
-                    case '\a':ret += "\\a";break;
-                    case '\b':ret += "\\b";break;
-                    case '\n':ret += "\\n";break;
-                    case '\r':ret += "\\r";break;
-                    case '\t':ret += "\\t";break;
-                    case '\\':ret += "\\\\";break;
-                    case '\"':ret += "\\\"";break;
-                    default: 
-                        if( iscntrl(c) ) {
-                            char buf[3];
-                            sprintf(buf,"%02x",c);
-                            ret += "\\u00" + std::string(buf);
-                        } else {
-                            ret += c;
-                        }break;
+/**
+ * @function scalarEscape : 查找需要转义的字节
+ * @desc :
+ *  返回[p,e)中第一个需要转义的字节的位置,若不存在,返回e
+ *  控制字符,删除符,引号和反斜杠需要转义
+ *  内核有标量,SSE2和AVX2三个版本,在启动时根据CPUID选择处理器支持的最快版本
+ */
+static const char* scalarEscape( const char* p, const char* e ) {
+    while( p < e and (unsigned char)*p >= 0x20 and *p != 0x7f and *p != '\"' and *p != '\\' ) p++;
+    return p;
+}
+
+#ifdef __alioth_simd__
+
+/**
+ * SSE2只有有符号比较,非ascii字节都是负数,所以控制字符的区间从0开始判断
+ */
+static const char* sse2Escape( const char* p, const char* e ) {
+    for( ; e - p >= 16; p += 16 ) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        __m128i c = _mm_and_si128(_mm_cmpgt_epi8(x,_mm_set1_epi8(-1)),_mm_cmplt_epi8(x,_mm_set1_epi8(0x20)));
+        __m128i q = _mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8('\"')),_mm_cmpeq_epi8(x,_mm_set1_epi8('\\')));
+        __m128i m = _mm_or_si128(_mm_or_si128(c,q),_mm_cmpeq_epi8(x,_mm_set1_epi8(0x7f)));
+        if( unsigned r = _mm_movemask_epi8(m); r ) return p + __builtin_ctz(r);
+    }
+    return scalarEscape(p,e);
+}
+
+__attribute__((target("avx2")))
+static const char* avx2Escape( const char* p, const char* e ) {
+    for( ; e - p >= 32; p += 32 ) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i c = _mm256_and_si256(_mm256_cmpgt_epi8(x,_mm256_set1_epi8(-1)),_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20),x));
+        __m256i q = _mm256_or_si256(_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\"')),_mm256_cmpeq_epi8(x,_mm256_set1_epi8('\\')));
+        __m256i m = _mm256_or_si256(_mm256_or_si256(c,q),_mm256_cmpeq_epi8(x,_mm256_set1_epi8(0x7f)));
+        if( unsigned r = _mm256_movemask_epi8(m); r ) return p + __builtin_ctz(r);
+    }
+    return sse2Escape(p,e);
+}
+
+#endif
+
+static auto chooseEscape() {
+#ifdef __alioth_simd__
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx2") ) return avx2Escape;
+    if( __builtin_cpu_supports("sse2") ) return sse2Escape;
+#endif
+    return scalarEscape;
+}
+
+static const char* (*const escape)( const char*, const char* ) = chooseEscape();
+
+class Jsonz::writer {
+    private:
+        char            mbuf[8192];
+        size_t          mused;
+        std::string*    mstr;
+        abon*           mbin;
+        std::ostream*   mos;
+
+        void sink( const char* p, size_t n ) {
+            if( mstr ) mstr->append(p,n);
+            else if( mbin ) mbin->insert(mbin->end(),p,p+n);
+            else mos->write(p,n);
+        }
+
+    public:
+        writer( std::string& str ):mused(0),mstr(&str),mbin(nullptr),mos(nullptr) {}
+        writer( abon& bin ):mused(0),mstr(nullptr),mbin(&bin),mos(nullptr) {}
+        writer( std::ostream& os ):mused(0),mstr(nullptr),mbin(nullptr),mos(&os) {}
+        ~writer() {flush();}
+
+        void put( char c ) {
+            if( mused == sizeof(mbuf) ) flush();
+            mbuf[mused++] = c;
+        }
+
+        void write( const char* p, size_t n ) {
+            if( n > sizeof(mbuf) - mused ) {
+                flush();
+                if( n >= sizeof(mbuf) ) return sink(p,n);
+            }
+            memcpy(mbuf + mused,p,n);
+            mused += n;
+        }
+
+        void write( std::string_view v ) {
+            write(v.data(),v.size());
+        }
+
+        /** 按照小端序写入定长的整数 */
+        void fixed( uint64_t v, size_t bytes ) {
+            for( size_t i = 0; i < bytes; i++ ) put((char)(v >> (i<<3)));
+        }
+
+        /** 写入带引号的json字符串,不需要转义的连续段被整体复制 */
+        void quote( std::string_view v ) {
+            const char* p = v.data();
+            const char* e = p + v.size();
+            put('\"');
+            while( p < e ) {
+                const char* q = escape(p,e);
+                write(p,q-p);
+                if( q == e ) break;
+                switch( char c = *q ) {
+                    case '\a':write("\\a",2);break;
+                    case '\b':write("\\b",2);break;
+                    case '\n':write("\\n",2);break;
+                    case '\r':write("\\r",2);break;
+                    case '\t':write("\\t",2);break;
+                    case '\\':write("\\\\",2);break;
+                    case '\"':write("\\\"",2);break;
+                    default: {
+                        static const char digits[] = "0123456789abcdef";
+                        char u[6] = {'\\','u','0','0',digits[(c>>4)&0x0f],digits[c&0x0f]};
+                        write(u,sizeof(u));
+                    } break;
                 }
+                p = q + 1;
             }
-            ret += "\"";
-        }break;
-        case JObject: {
-            const jobject& obj = *(jobject*)mdata;
-            size_t count = obj.size();
-            ret = "{";
-            for( auto& p : obj ) {
-                Jsonz k;
-                k = p.first;
-                ret += k.toJson() + ":" + p.second.toJson();
-                if( count-- > 1 ) ret += ",";
+            put('\"');
+        }
+
+        void flush() {
+            if( mused ) sink(mbuf,mused);
+            mused = 0;
+        }
+};
+
+void Jsonz::json( writer& w )const {
+    switch( mtype ) {
+        case JNull: w.write("null",4);break;
+        case JBoolean: mbool ? w.write("true",4) : w.write("false",5);break;
+        case JInteger: {
+            char buf[24];
+            w.write(buf,snprintf(buf,sizeof(buf),"%lld",mint));
+        } break;
+        case JReal: {
+            char buf[512];
+            w.write(buf,snprintf(buf,sizeof(buf),"%f",mreal));
+        } break;
+        case JString: w.quote(view());break;
+        case JObject:
+            w.put('{');
+            for( uint32_t n = 0; n < msize; n++ ) {
+                auto& m = ((const member*)mheap)[n];
+                if( n ) w.put(',');
+                w.quote(m.key.view());
+                w.put(':');
+                m.value.json(w);
             }
-            ret += "}";
-        }break;
-        case JArray: {
-            const jarray& arr = *(jarray*)mdata;
-            size_t count = arr.size();
-            ret = "[";
-            for( auto& v : arr ) {
-                ret += v.toJson();
-                if( count-- > 1 ) ret += ",";
+            w.put('}');
+            break;
+        case JArray:
+            w.put('[');
+            for( uint32_t n = 0; n < msize; n++ ) {
+                if( n ) w.put(',');
+                ((const Jsonz*)mheap)[n].json(w);
             }
-            ret += "]";
-        }break;
+            w.put(']');
+            break;
     }
-    return ret;
 }
 
-abon Jsonz::toAbon() const {
-    abon ret;
+void Jsonz::binary( writer& w )const {
     switch( mtype ) {
-        case JNull: ret.push_back(TAG_NULL);break;
-        case JBoolean: ret.push_back((*(const bool*)&mdata)?TAG_TRUE:TAG_FALSE);break;
+        case JNull: w.put(TAG_NULL);break;
+        case JBoolean: w.put(mbool?TAG_TRUE:TAG_FALSE);break;
         case JInteger:
-            ret.push_back(TAG_INT);
-            for( size_t i = 0; i < sizeof(int); i++ )
-                ret.push_back(i[(const char*)&mdata]);
-            break;
-        case JReal:
-            ret.push_back(TAG_REAL);
-            for( size_t i = 0; i < sizeof(double); i++ )
-                ret.push_back(i[(const char*)&mdata]);
+            if( mint == (int)mint ) {
+                w.put(TAG_INT);
+                w.fixed((uint64_t)mint,sizeof(int));
+            } else {
+                w.put(TAG_LONG);
+                w.fixed((uint64_t)mint,sizeof(long long));
+            } break;
+        case JReal: {
+            uint64_t v;
+            memcpy(&v,&mreal,sizeof(v));
+            w.put(TAG_REAL);
+            w.fixed(v,sizeof(double));
+        } break;
+        case JString:
+            w.put(TAG_STR);
+            w.write(view());
+            w.put(0);
             break;
         case JArray:
-            ret.push_back(TAG_ARR);
-            for( auto& i : *(const jarray*)mdata ) {
-                auto t = i.toAbon();
-                ret.insert(ret.end(),t.begin(),t.end());
-            }
-            ret.push_back(END_ARR);
-            break;
-        case JString:
-            ret.push_back(TAG_STR);
-            for( char c : *(const std::string*)mdata ) ret.push_back(c);
-            ret.push_back(0);
+            w.put(TAG_ARR);
+            for( uint32_t n = 0; n < msize; n++ ) ((const Jsonz*)mheap)[n].binary(w);
+            w.put(END_ARR);
             break;
         case JObject:
-            ret.push_back(TAG_OBJ);
-            for( auto& p : *(const jobject*)mdata ) {
-                ret.push_back(TAG_STR);
-                for( char c : p.first ) ret.push_back(c);
-                ret.push_back(0);
-                auto t = p.second.toAbon();
-                ret.insert(ret.end(),t.begin(),t.end());
+            w.put(TAG_OBJ);
+            for( uint32_t n = 0; n < msize; n++ ) {
+                auto& m = ((const member*)mheap)[n];
+                m.key.binary(w);
+                m.value.binary(w);
             }
-            ret.push_back(END_OBJ);
+            w.put(END_OBJ);
             break;
     }
-    return std::move(ret);
+}
+
+std::string Jsonz::toJson() const {
+    std::string ret;
+    toJson(ret);
+    return ret;
+}
+
+void Jsonz::toJson( std::string& out )const {
+    writer w(out);
+    json(w);
+}
+
+void Jsonz::toJson( std::ostream& os )const {
+    writer w(os);
+    json(w);
+}
+
+abon Jsonz::toAbon( int version ) const {
+    abon ret;
+    toAbon(ret,version);
+    return ret;
+}
+
+void Jsonz::toAbon( abon& out, int version )const {
+    if( version == 2 ) {
+        out.insert(out.end(),MAGIC,MAGIC + sizeof(MAGIC));
+        indexed(out);
+    } else {
+        writer w(out);
+        binary(w);
+    }
+}
+
+void Jsonz::toAbon( std::ostream& os, int version )const {
+    if( version == 2 ) {
+        abon out;
+        toAbon(out,2);
+        os.write(out.data(),out.size());
+    } else {
+        writer w(os);
+        binary(w);
+    }
+}
+
+/** 按照小端序写入32位整数 */
+static inline void put32( abon& out, uint32_t v ) {
+    for( size_t i = 0; i < 4; i++ ) out.push_back((char)(v >> (i<<3)));
+}
+
+/** 按照小端序改写已经写入的32位整数 */
+static inline void patch32( abon& out, size_t at, uint32_t v ) {
+    for( size_t i = 0; i < 4; i++ ) out[at+i] = (char)(v >> (i<<3));
+}
+
+/** 按照小端序读取32位整数 */
+static inline uint32_t get32( const char* p ) {
+    auto u = (const unsigned char*)p;
+    return (uint32_t)u[0] | (uint32_t)u[1] << 8 | (uint32_t)u[2] << 16 | (uint32_t)u[3] << 24;
+}
+
+/**
+ * 容器的主体长度和索引在写入内容之前占位,内容写入之后再回填
+ */
+void Jsonz::indexed( abon& out )const {
+    switch( mtype ) {
+        case JString: {
+            auto v = view();
+            out.push_back(TAG_STR);
+            put32(out,v.size());
+            out.insert(out.end(),v.begin(),v.end());
+        } break;
+        case JArray: {
+            out.push_back(TAG_ARR);
+            size_t len = out.size();
+            put32(out,0);
+            size_t body = out.size();
+            put32(out,msize);
+            size_t index = out.size();
+            out.resize(index + msize * 4);
+            for( uint32_t n = 0; n < msize; n++ ) {
+                patch32(out,index + n * 4,out.size() - body);
+                ((const Jsonz*)mheap)[n].indexed(out);
+            }
+            patch32(out,len,out.size() - body);
+        } break;
+        case JObject: {
+            out.push_back(TAG_OBJ);
+            size_t len = out.size();
+            put32(out,0);
+            size_t body = out.size();
+            put32(out,msize);
+            size_t index = out.size();
+            out.resize(index + msize * 12);
+            for( uint32_t n = 0; n < msize; n++ ) {
+                auto k = ((const member*)mheap)[n].key.view();
+                patch32(out,index + n * 12,out.size() - body);
+                patch32(out,index + n * 12 + 4,k.size());
+                out.insert(out.end(),k.begin(),k.end());
+            }
+            for( uint32_t n = 0; n < msize; n++ ) {
+                patch32(out,index + n * 12 + 8,out.size() - body);
+                ((const member*)mheap)[n].value.indexed(out);
+            }
+            patch32(out,len,out.size() - body);
+        } break;
+        default: {
+            writer w(out);
+            binary(w);
+        } break;
+    }
+}
+
+JsonzView::JsonzView():mdata(nullptr),mend(nullptr) {
+
+}
+
+/**
+ * 构造视图时检查值是否完整地位于区域之内,容器还要求主体至少能容纳元素个数和索引
+ * 此后的访问只需检查索引中的偏移
+ */
+JsonzView::JsonzView( const char* data, const char* end ):mdata(nullptr),mend(nullptr) {
+    if( !data or data >= end ) return;
+    size_t room = end - data - 1;
+    size_t need = 0;
+    switch( *data ) {
+        case TAG_NULL: case TAG_TRUE: case TAG_FALSE: need = 0;break;
+        case TAG_INT: need = 4;break;
+        case TAG_LONG: case TAG_REAL: need = 8;break;
+        case TAG_STR: case TAG_ARR: case TAG_OBJ:
+            if( room < 4 ) return;
+            need = 4 + (size_t)get32(data + 1);
+            break;
+        default: return;
+    }
+    if( need > room ) return;
+    if( *data == TAG_ARR or *data == TAG_OBJ ) {
+        size_t len = get32(data + 1);
+        if( len < 4 or (size_t)get32(data + 5) * (*data == TAG_ARR ? 4 : 12) > len - 4 ) return;
+    }
+    mdata = data;
+    mend = end;
+}
+
+JsonzView JsonzView::fromAbon( const char* data, size_t size ) {
+    if( !probe(data,size) ) return JsonzView();
+    return JsonzView(data + sizeof(MAGIC),data + size);
+}
+
+bool JsonzView::probe( const char* data, size_t size ) {
+    return data and size >= sizeof(MAGIC) and memcmp(data,MAGIC,sizeof(MAGIC)) == 0;
+}
+
+const char* JsonzView::body()const {
+    return mdata + 5;
+}
+
+const char* JsonzView::limit()const {
+    return mdata + 5 + get32(mdata + 1);
+}
+
+bool JsonzView::good()const {
+    return mdata != nullptr;
+}
+
+JType JsonzView::tell()const {
+    if( !mdata ) return JNull;
+    switch( *mdata ) {
+        case TAG_TRUE: case TAG_FALSE: return JBoolean;
+        case TAG_INT: case TAG_LONG: return JInteger;
+        case TAG_REAL: return JReal;
+        case TAG_STR: return JString;
+        case TAG_ARR: return JArray;
+        case TAG_OBJ: return JObject;
+        default: return JNull;
+    }
+}
+
+bool JsonzView::is( JType type )const {
+    return tell() == type;
+}
+
+JsonzView::operator int()const {
+    return (int)(long long)*this;
+}
+
+JsonzView::operator long long()const {
+    if( !mdata ) return 0;
+    if( *mdata == TAG_INT ) return (int)get32(mdata + 1);
+    if( *mdata == TAG_LONG ) return (long long)((uint64_t)get32(mdata + 1) | (uint64_t)get32(mdata + 5) << 32);
+    return 0;
+}
+
+JsonzView::operator double()const {
+    if( !mdata or *mdata != TAG_REAL ) return 0;
+    uint64_t v = (uint64_t)get32(mdata + 1) | (uint64_t)get32(mdata + 5) << 32;
+    double d;
+    memcpy(&d,&v,sizeof(d));
+    return d;
+}
+
+JsonzView::operator bool()const {
+    return mdata and *mdata == TAG_TRUE;
+}
+
+JsonzView::operator std::string()const {
+    return std::string(text());
+}
+
+std::string_view JsonzView::text()const {
+    if( !mdata or *mdata != TAG_STR ) return std::string_view();
+    return std::string_view(mdata + 5,get32(mdata + 1));
+}
+
+size_t JsonzView::count()const {
+    if( !is(JArray) and !is(JObject) ) return 0;
+    return get32(body());
+}
+
+size_t JsonzView::count( std::string_view key )const {
+    return at(key).good();
+}
+
+JsonzView JsonzView::at( std::string_view key )const {
+    if( !is(JObject) ) return JsonzView();
+    const char* b = body();
+    size_t len = limit() - b;
+    size_t lo = 0, hi = get32(b);
+    while( lo < hi ) {
+        size_t mid = (lo + hi) / 2;
+        const char* entry = b + 4 + mid * 12;
+        size_t off = get32(entry), n = get32(entry + 4);
+        if( off > len or n > len - off ) return JsonzView();
+        int cmp = std::string_view(b + off,n).compare(key);
+        if( cmp == 0 ) {
+            size_t val = get32(entry + 8);
+            if( val >= len ) return JsonzView();
+            return JsonzView(b + val,limit());
+        }
+        if( cmp < 0 ) lo = mid + 1;
+        else hi = mid;
+    }
+    return JsonzView();
+}
+
+JsonzView JsonzView::at( int index )const {
+    if( !is(JArray) ) return JsonzView();
+    const char* b = body();
+    long long n = get32(b);
+    if( index < 0 ) index += n;
+    if( index < 0 or index >= n ) return JsonzView();
+    size_t off = get32(b + 4 + index * 4);
+    if( off >= size_t(limit() - b) ) return JsonzView();
+    return JsonzView(b + off,limit());
+}
+
+int JsonzView::foreach( std::function<bool(const JsonzView&)> fun )const {
+    if( !is(JArray) ) return -1;
+    int i = 0;
+    for( int n = 0, c = count(); n < c; n++ )
+        if( !fun(at(n)) ) break;
+        else i += 1;
+    return i;
+}
+
+int JsonzView::foreach( std::function<bool(std::string_view,const JsonzView&)> fun )const {
+    if( !is(JObject) ) return -1;
+    const char* b = body();
+    size_t len = limit() - b;
+    int i = 0;
+    for( size_t n = 0, c = count(); n < c; n++ ) {
+        const char* entry = b + 4 + n * 12;
+        size_t off = get32(entry), kn = get32(entry + 4), val = get32(entry + 8);
+        if( off > len or kn > len - off or val >= len ) break;
+        if( !fun(std::string_view(b + off,kn),JsonzView(b + val,limit())) ) break;
+        else i += 1;
+    }
+    return i;
+}
+
+bool JsonzView::parse( Jsonz::handler& h )const {
+    struct frame {
+        JsonzView   container;
+        size_t      next;
+        size_t      count;
+    };
+    std::vector<frame> stack;
+    JsonzView v = *this;
+
+    while( true ) {
+        if( !v.good() ) return false;
+        bool ok = true;
+        switch( *v.mdata ) {
+            case TAG_NULL: ok = h.null();break;
+            case TAG_TRUE: case TAG_FALSE: ok = h.boolean((bool)v);break;
+            case TAG_INT: case TAG_LONG: ok = h.integer((long long)v);break;
+            case TAG_REAL: ok = h.real((double)v);break;
+            case TAG_STR: ok = h.text(v.text());break;
+            case TAG_ARR: ok = h.openArray();stack.push_back((frame){v,0,v.count()});break;
+            case TAG_OBJ: ok = h.openObject();stack.push_back((frame){v,0,v.count()});break;
+        }
+        if( !ok ) return false;
+
+        /** 闭合所有已经遍历完毕的容器,然后取出下一个值 */
+        while( !stack.empty() and stack.back().next == stack.back().count ) {
+            ok = stack.back().container.is(JArray) ? h.closeArray() : h.closeObject();
+            stack.pop_back();
+            if( !ok ) return false;
+        }
+        if( stack.empty() ) return true;
+
+        auto& f = stack.back();
+        auto i = f.next++;
+        if( f.container.is(JArray) ) {
+            v = f.container.at((int)i);
+        } else {
+            const char* b = f.container.body();
+            size_t len = f.container.limit() - b;
+            const char* entry = b + 4 + i * 12;
+            size_t off = get32(entry), kn = get32(entry + 4), val = get32(entry + 8);
+            if( off > len or kn > len - off or val >= len ) return false;
+            if( !h.key(std::string_view(b + off,kn)) ) return false;
+            v = JsonzView(b + val,f.container.limit());
+        }
+    }
+}
+
+Jsonz JsonzView::decode()const {
+    builder b;
+    if( !parse(b) ) return Jsonz(JNull);
+    return std::move(b.root);
+}
+
+static constexpr size_t alignment = 8;
+static constexpr size_t header = (sizeof(size_t)*3 + alignment - 1) / alignment * alignment;
+static constexpr size_t initial = 16 << 10;
+static constexpr size_t largest = 1 << 20;
+
+JsonzDocument::scope::scope( JsonzDocument* doc ):mprev(active) {
+    active = doc;
+}
+
+JsonzDocument::scope::~scope() {
+    active = mprev;
+}
+
+JsonzDocument::JsonzDocument():mblocks(nullptr),mbytes(0) {
+
+}
+
+JsonzDocument::JsonzDocument( JsonzDocument&& an ):mblocks(an.mblocks),mbytes(an.mbytes),mroot(std::move(an.mroot)) {
+    an.mblocks = nullptr;
+    an.mbytes = 0;
+}
+
+JsonzDocument& JsonzDocument::operator=( JsonzDocument&& an ) {
+    if( &an == this ) return *this;
+    release();
+    mblocks = an.mblocks;
+    mbytes = an.mbytes;
+    mroot = std::move(an.mroot);
+    an.mblocks = nullptr;
+    an.mbytes = 0;
+    return *this;
+}
+
+JsonzDocument::~JsonzDocument() {
+    release();
+}
+
+JsonzDocument* JsonzDocument::current() {
+    return active;
+}
+
+void* JsonzDocument::allocate( size_t size ) {
+    size = (size + alignment - 1) / alignment * alignment;
+    if( !mblocks or mblocks->used + size > mblocks->size ) {
+        size_t cap = mblocks ? mblocks->size * 2 : initial;
+        if( cap > largest ) cap = largest;
+        if( cap < size ) cap = size;
+        auto b = (block*)malloc(header + cap);
+        b->next = mblocks;
+        b->size = cap;
+        b->used = 0;
+        mblocks = b;
+    }
+    void* p = (char*)mblocks + header + mblocks->used;
+    mblocks->used += size;
+    mbytes += size;
+    return p;
+}
+
+Jsonz& JsonzDocument::root() {
+    return mroot;
+}
+
+const Jsonz& JsonzDocument::root()const {
+    return mroot;
+}
+
+size_t JsonzDocument::size()const {
+    return mbytes;
+}
+
+/**
+ * 驻留的存储区不被单独释放,清空根只是为了释放从堆上移入文档的值
+ */
+void JsonzDocument::release() {
+    mroot.clear();
+    while( mblocks ) {
+        auto b = mblocks;
+        mblocks = b->next;
+        free(b);
+    }
+    mbytes = 0;
 }
 
 #endif
\ No newline at end of file
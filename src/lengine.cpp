@@ -2,6 +2,7 @@
 #define __lengine_cpp__
 
 #include "lengine.hpp"
+#include "srcmap.hpp"
 #include <regex>
 
 namespace alioth {
@@ -20,38 +21,166 @@ Lengine::logs Lengine::fordoc(const string& fname) {
     return move(logs(fname));
 }
 
+bool Lengine::validate( const logt& tm ) {
+    static const regex rpos(R"(n|(b|e)\d+)"); //使用正则表达式判断模式是否满足格式
+    return regex_match(tm.beg,rpos) and regex_match(tm.end,rpos);
+}
+
+void Lengine::attach( logt& tm, const chainz<int>& item ) {
+    tm.sub.construct(-1);
+    tm.sub[-1].tno = item.size() > 0 ? item[0] : 0;
+    tm.sub[-1].pat = item.size() > 1 ? item[1] : 0;
+    for( int i = 2; i < item.size(); i++ ) tm.sub[-1].arg << item[i];
+}
+
+template<typename J>
+bool Lengine::decode( const J& tmpl, logt& tm ) {
+    bool hsev = false, hbeg = false, hend = false, hmsg = false;
+    tmpl.foreach([&]( auto k, const J& v ) -> bool {
+        if( k == "sev" and v.is(JInteger) ) {tm.sev = (Severity)(int)v;hsev = true;}
+        else if( k == "beg" and v.is(JString) ) {tm.beg = (string)v;hbeg = true;}
+        else if( k == "end" and v.is(JString) ) {tm.end = (string)v;hend = true;}
+        else if( k == "msg" and v.is(JString) ) {tm.msg = (string)v;hmsg = true;}
+        else if( k == "sub" ) v.foreach([&]( const J& sub ) -> bool {
+            chainz<int> item;
+            sub.foreach([&]( const J& i ) -> bool {item << (int)i;return true;});
+            attach(tm,item);
+            return true;
+        });
+        return true;
+    });
+    return hsev and hbeg and hend and hmsg and validate(tm);
+}
+
 bool Lengine::config( const Jsonz& conf ) {
     if( conf.test<JBoolean>("color") ) mecolor = (bool)conf.at("color");
     if( conf.test<JBoolean>("path") ) mepath = (bool)conf.at("path");
     if( conf.turn<JObject>("tmpls",[&](const Jsonz& tmpls ){
-
-        auto rpos = regex(R"(n|(b|e)\d+)"); //使用正则表达式判断模式是否满足格式
         tmpls.foreach([&](const string& k, const Jsonz& tmpl) -> bool{
             char* end = nullptr;
             int ki = strtol(k.data(),&end,10);
-            if( end and tmpl.test<JInteger>("sev") and tmpl.test<JString>("beg","end","msg") and regex_match((string)tmpl.at("beg"),rpos) and regex_match((string)tmpl.at("end"),rpos) ) {
-                auto& tm = mrepo[ki] = (logt){
-                    sev: (Severity)(int)tmpl.at("sev"),
-                    beg: (string)tmpl.at("beg"),
-                    end: (string)tmpl.at("end"),
-                    msg: (string)tmpl.at("msg")
-                };
-
-                if( tmpl.test<JArray>("sub") ) tmpl.at("sub").foreach([&](const Jsonz& sub ) -> bool {
-                    #warning [TODO]:安全性的检查
-                    tm.sub.construct(-1);
-                    tm.sub[-1].tno = (int)sub.at(0);
-                    tm.sub[-1].pat = (int)sub.at(1);
-                    for( size_t i = 2; i < sub.count(); i++ ) tm.sub[-1].arg << (int)sub.at(i);
-                    return true;
-                });
-            }
+            logt tm;
+            if( end and decode(tmpl,tm) ) mrepo[ki] = move(tm);
             return true;
         });
     })) return true;
     return false;
 }
 
+bool Lengine::config( const char* data, size_t size ) {
+
+    /**
+     * 配置读取器按照嵌套深度识别配置项
+     *  深度1 : 配置对象,键为配置项
+     *  深度2 : 模板表,键为模板号
+     *  深度3 : 模板,键为模板的字段
+     *  深度4,5 : 子日志表及其中的每个子日志
+     * 模板在闭合时经过和其他途径相同的检查后才被加入仓库
+     */
+    struct reader : public Jsonz::handler {
+        Lengine& eng;
+        int depth = 0;
+        bool tmpls = false;
+        bool intmpls = false;
+        bool intmpl = false;
+        bool insub = false;
+        bool initem = false;
+        string section;
+        string field;
+        int ki = 0;
+        logt tm;
+        bool hsev = false, hbeg = false, hend = false, hmsg = false;
+        chainz<int> item;
+
+        reader( Lengine& e ):eng(e) {}
+
+        bool key( std::string_view k )override {
+            if( depth == 1 ) section.assign(k.data(),k.size());
+            else if( intmpls and depth == 2 ) ki = strtol(string(k).data(),nullptr,10);
+            else if( intmpl and depth == 3 ) field.assign(k.data(),k.size());
+            return true;
+        }
+        bool boolean( bool v )override {
+            if( depth == 1 and section == "color" ) eng.mecolor = v;
+            else if( depth == 1 and section == "path" ) eng.mepath = v;
+            return true;
+        }
+        bool integer( long long v )override {
+            if( intmpl and depth == 3 and field == "sev" ) {tm.sev = (Severity)v;hsev = true;}
+            else if( initem and depth == 5 ) item << v;
+            return true;
+        }
+        bool text( std::string_view v )override {
+            if( !intmpl or depth != 3 ) return true;
+            if( field == "beg" ) {tm.beg.assign(v.data(),v.size());hbeg = true;}
+            else if( field == "end" ) {tm.end.assign(v.data(),v.size());hend = true;}
+            else if( field == "msg" ) {tm.msg.assign(v.data(),v.size());hmsg = true;}
+            return true;
+        }
+        bool openObject()override {
+            depth += 1;
+            if( depth == 2 and section == "tmpls" ) tmpls = intmpls = true;
+            else if( intmpls and depth == 3 ) {
+                intmpl = true;
+                tm = logt();
+                hsev = hbeg = hend = hmsg = false;
+            }
+            return true;
+        }
+        bool closeObject()override {
+            if( intmpl and depth == 3 ) {
+                intmpl = false;
+                if( hsev and hbeg and hend and hmsg and validate(tm) ) eng.mrepo[ki] = move(tm);
+            } else if( intmpls and depth == 2 ) {
+                intmpls = false;
+            }
+            depth -= 1;
+            return true;
+        }
+        bool openArray()override {
+            depth += 1;
+            if( intmpl and depth == 4 and field == "sub" ) insub = true;
+            else if( insub and depth == 5 ) {
+                initem = true;
+                item.clear();
+            }
+            return true;
+        }
+        bool closeArray()override {
+            if( initem and depth == 5 ) {
+                initem = false;
+                attach(tm,item);
+            } else if( insub and depth == 4 ) {
+                insub = false;
+            }
+            depth -= 1;
+            return true;
+        }
+    } rd(*this);
+
+    return Jsonz::parse(data,size,rd) and rd.tmpls;
+}
+
+bool Lengine::config( Dengine::vmap&& catalogue ) {
+    if( !catalogue.good() ) return false;
+    if( !JsonzView::probe(catalogue.data(),catalogue.size()) ) return config(catalogue.data(),catalogue.size());
+
+    mcatalogue = move(catalogue);
+    auto conf = JsonzView::fromAbon(mcatalogue.data(),mcatalogue.size());
+    if( conf.at("color").is(JBoolean) ) mecolor = (bool)conf.at("color");
+    if( conf.at("path").is(JBoolean) ) mepath = (bool)conf.at("path");
+    mtmpls = conf.at("tmpls");
+    return mtmpls.is(JObject);
+}
+
+const Lengine::logt* Lengine::lookup( int tno ) {
+    if( auto it = mrepo.find(tno); it != mrepo.end() ) return &it->second;
+
+    logt tm;
+    if( !decode(mtmpls.at(to_string(tno)),tm) ) return nullptr;
+    return &(mrepo[tno] = move(tm));
+}
+
 void Lengine::color( bool c ) {
     mecolor = c;
 }
@@ -78,6 +207,11 @@ Jsonz Lengine::operator() ( const logr& lr ) {
     return move(rep);
 }
 
+Jsonz& Lengine::operator() ( const logr& lr, JsonzDocument& doc ) {
+    JsonzDocument::scope active(&doc);
+    return doc.root() = operator()(lr);
+}
+
 Jsonz Lengine::operator() ( const logs& ls ) {
     Jsonz rep = JArray;
 
@@ -99,8 +233,9 @@ Jsonz Lengine::operator() ( const logi& li ) {
     bool colored = false;
     Jsonz ret = JObject;
 
-    if( !mrepo.count(li.tno) ) return JNull;
-    auto tmpl = mrepo.at(li.tno);
+    auto found = lookup(li.tno);
+    if( !found ) return JNull;
+    auto tmpl = *found;
     
     ret["sev"] = tmpl.sev;
 
@@ -111,8 +246,10 @@ Jsonz Lengine::operator() ( const logi& li ) {
         long ind = strtol(tmpl.beg.data()+1, 0, 10 );
         auto& arg = li.arg[ind];
         if( zero(&arg) ) return JNull;
-        ret["begl"] = (tmpl.beg[0]=='b')?arg.bl:arg.el;
-        ret["begc"] = (tmpl.beg[0]=='b')?arg.bc:arg.ec;
+        int l, c;
+        srcmap::locate((tmpl.beg[0]=='b')?arg.bo:arg.eo,l,c);
+        ret["begl"] = l;
+        ret["begc"] = c;
     }
 
     if( tmpl.end == "n" ) {
@@ -122,8 +259,10 @@ Jsonz Lengine::operator() ( const logi& li ) {
         long ind = strtol(tmpl.end.data()+1, 0, 10 );
         auto& arg = li.arg[ind];
         if( zero(&arg) ) return JNull;
-        ret["endl"] = (tmpl.end[0]=='b')?arg.bl:arg.el;
-        ret["endc"] = (tmpl.end[0]=='b')?arg.bc:arg.ec;
+        int l, c;
+        srcmap::locate((tmpl.end[0]=='b')?arg.bo:arg.eo,l,c);
+        ret["endl"] = l;
+        ret["endc"] = c;
     }
 
     if( mepath ) {
@@ -5,6 +5,8 @@
 
 namespace alioth{
 
+LoopImpl::LoopImpl():implementation(cthing::LoopImpl) {}
+
 bool LoopImpl::is( cnode c ) const {
     return c == IMPLEMENTATION or c == LOOPIMPL;
 }
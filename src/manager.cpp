@@ -7,16 +7,27 @@
 #include "yengine.hpp"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Object/ArchiveWriter.h"
+#include "lld/Common/Driver.h"
+#include "lld/Common/ErrorHandler.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <fstream>
+#include <sstream>
 #include <cstdlib>
 #include <cstdio>
+#include <cerrno>
 #include<fcntl.h>
 #include<stdio.h>
-#include <wait.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <condition_variable>
 
 namespace alioth {
 using namespace std;
@@ -29,21 +40,69 @@ static bool isalioth( const string& name ) {
     return true;
 }
 
-static int whichCmd( char* buf, const string& cmd ) {
-    int io[2];
-    int 
-        so = dup(1),
-        si = dup(0);
-    if( pipe(io) ) return -1;
-    dup2(io[1],1);
-    dup2(io[0],0);
-    auto ret = system( ("which "+cmd).c_str() );
-    if( ret == 0 ) scanf("%s",buf);
-    dup2(so,1);
-    dup2(si,0);
-    close(io[0]);
-    close(io[1]);
-    return ret;
+/**
+ * @function linkExecutable : 链接可执行文件
+ * @desc :
+ *  使用lld的库接口完成链接,参数与ld的命令行参数相同
+ *  lld的错误计数是全局的,每次链接之前都要清零,否则上一次链接的错误会使本次链接失败
+ *  lld遇到致命错误时会直接结束进程,所以常驻的管理器在子进程中链接,以免整个服务随之退出
+ * @param args : 链接参数,首个参数为程序名
+ * @param isolate : 是否在子进程中链接
+ * @return bool : 是否成功
+ */
+static bool linkExecutable( const vector<string>& args, bool isolate ) {
+    vector<const char*> sargs;
+    for( auto& arg : args ) sargs.push_back(arg.c_str());
+    if( !isolate ) {
+        lld::errorHandler().ErrorCount = 0;
+        return lld::elf::link(sargs,false,llvm::errs());
+    }
+
+    cout.flush();
+    llvm::errs().flush();
+    fflush(nullptr);
+    auto pid = fork();
+    if( pid < 0 ) return false;
+    if( pid == 0 ) {
+        lld::errorHandler().ErrorCount = 0;
+        bool ok = lld::elf::link(sargs,false,llvm::errs());
+        llvm::errs().flush();
+        _exit(ok?0:1);
+    }
+
+    int status = 0;
+    while( waitpid(pid,&status,0) < 0 ) if( errno != EINTR ) return false;
+    return WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @function archiveObjects : 归档目标文件
+ * @desc :
+ *  使用llvm的归档写入器产生静态链接库,效果与ar -rcs相同
+ *  若目标文件的映像仍在内存中,则直接使用映像,否则从文件读取
+ * @param path : 静态链接库路径
+ * @param objs : 目标文件路径
+ * @param images : 内存中的目标文件映像
+ * @return bool : 是否成功
+ */
+static bool archiveObjects( const string& path, const vector<string>& objs, const map<string,string>& images ) {
+    using namespace llvm;
+    vector<NewArchiveMember> members;
+    for( auto& obj : objs ) {
+        if( auto i = images.find(obj); i != images.end() ) {
+            members.emplace_back(MemoryBufferRef(i->second,sys::path::filename(obj)));
+        } else if( auto member = NewArchiveMember::getFile(obj,true); member ) {
+            members.push_back(move(*member));
+        } else {
+            logAllUnhandledErrors(member.takeError(),errs(),"ar: ");
+            return false;
+        }
+    }
+    if( auto error = writeArchive(path,members,true,object::Archive::K_GNU,true,false) ) {
+        logAllUnhandledErrors(move(error),errs(),"ar: ");
+        return false;
+    }
+    return true;
 }
 
 void Manager::recordMissing($depdesc D, $modesc M, Lengine::logs& log ) {
@@ -91,7 +150,7 @@ bool Manager::verifyDependenceStack( $modesc dep, Lengine::logs& log ) {
     return true;
 }
 
-Manager::Manager(){
+Manager::Manager():mjobs(1),mloaded(false),mresident(false){
 
 }
 
@@ -118,6 +177,72 @@ int Manager::verifyAppName()const {
     return 0;
 }
 
+void Manager::setJobs( int jobs ) {
+    if( jobs < 1 ) jobs = thread::hardware_concurrency();
+    mjobs = jobs < 1 ? 1 : jobs;
+}
+
+int Manager::getJobs() const {
+    return mjobs;
+}
+
+void Manager::parallel( size_t count, const function<void(size_t)>& task ) {
+    size_t jobs = min((size_t)mjobs,count);
+    if( jobs < 2 ) {
+        for( size_t i = 0; i < count; i++ ) task(i);
+        return;
+    }
+
+    atomic<size_t> next(0);
+    auto work = [&]{ for( size_t i; (i = next++) < count; ) task(i); };
+    vector<thread> workers;
+    for( size_t i = 1; i < jobs; i++ ) workers.emplace_back(work);
+    work();
+    for( auto& worker : workers ) worker.join();
+}
+
+void Manager::setResident( bool resident ) {
+    mresident = resident;
+    if( !mresident ) mlexcache.clear();
+}
+
+bool Manager::isResident()const {
+    return mresident;
+}
+
+tokens Manager::lexDocument( const string& path, string_view src, Xengine::edit* change ) {
+    if( change ) change->b = -1;
+    if( !mresident ) return Xengine(path).parseSourceCode(src.data(),src.size(),nullptr);
+
+    auto hash = hexdigest(digest(src));
+    decltype(mlexcache)::mapped_type* entry;
+    {
+        lock_guard<mutex> lock(mlexmutex);
+        entry = &mlexcache[path];
+    }
+
+    auto& [ohash,ots,osrc] = *entry;
+    if( ohash.empty() ) {
+        ots = Xengine(path).parseSourceCode(src.data(),src.size(),nullptr);
+        ohash = hash;
+        osrc.assign(src.data(),src.size());
+        return ots;
+    }
+
+    auto ed = Xengine::diff(osrc,src);
+    if( ohash != hash ) {
+        ots = Xengine(path).relexSourceCode(ots,src.data(),src.size(),ed);
+        ohash = hash;
+        osrc.assign(src.data(),src.size());
+    }
+    if( change ) *change = ed;
+    return ots;
+}
+
+Pengine& Manager::getPerformanceEngine() {
+    return mpengine;
+}
+
 Dengine& Manager::getDocumentEngine() {
     return mdengine;
 }
@@ -137,15 +262,88 @@ bool Manager::config( Jsonz conf ) {
     return true;
 }
 
+/**
+ * @struct mtrecord : 模块描述符表的内容
+ * @desc :
+ *  模块描述符表可以从json文本中读取,也可以从带索引的abon编码中读取
+ *  两种编码由同一个读取器读入此结构,再统一装入模块描述符
+ */
+struct mtrecord {
+    struct dep {
+        string name;
+        string from;
+        string alias;
+    };
+    struct desc {
+        string          name;
+        bool            hdocs = false;
+        bool            hdeps = false;
+        bool            hstamp = false;
+        bool            hface = false;
+        bool            bad = false;        //存在不能识别的源文档描述或依赖描述
+        string          stamp;
+        string          face;
+        vector<Dengine::vfd> docs;
+        vector<dep>     deps;
+    };
+    string          name;
+    int             mtim = 0;
+    bool            hname = false;
+    bool            hmtim = false;
+    bool            hdescs = false;
+    vector<desc>    descs;
+};
+
+/**
+ * @function install : 装入模块描述符表
+ * @desc :
+ *  将读取到的模块描述符表装入模块描述符表对象,已经存在的模块描述符被更新
+ * @param mana : 管理器
+ * @param descs : 目标
+ * @param table : 模块描述符表的内容
+ * @return bool : 是否所有内容都被正确地装入
+ */
+static bool install( Manager& mana, modescs& descs, const mtrecord& table ) {
+    if( !table.hname or !table.hdescs or !table.hmtim ) return false;
+
+    descs.aname = table.name;
+    descs.mtim = table.mtim;
+    bool error = false;
+
+    for( auto& v : table.descs ) {
+        $modesc ref;
+
+        if( !v.hdocs or !v.hdeps ) {error = true;continue;}
+
+        for( auto& desc : descs )
+            if( desc->program == descs.aname and desc->name == v.name ) {ref = desc;break;}
+        if( ref == nullptr ) descs << (ref = new modesc(mana,v.name,descs.aname));
+        if( v.hstamp ) ref->objstamp = v.stamp;
+        if( v.hface ) ref->face = v.face;
+        if( v.bad ) error = true;
+
+        for( auto& vfd : v.docs ) ref->appendDocument(vfd);
+        for( auto& dep : v.deps ) {
+            $depdesc m = new depdesc;
+            m->name = token(dep.name);
+            if( !dep.from.empty() ) m->mfrom = token(dep.from);
+            if( !dep.alias.empty() ) m->alias = token(dep.alias);
+            m->self = ref;
+            ref->deps << m;
+        }
+    }
+
+    return !error;
+}
+
 bool Manager::loadModescTable( vspace space, const string& app ) {
     
     if( space == Apps and app.empty() ) return loadModescTable(mapps);
-    uistream is = mdengine.getIs("mtable.json",space,app);
-    if( !is ) return false;
-    auto table = Jsonz::fromJsonStream(*is);
-    if( !table.is(JObject) ) return false;
+    auto src = mdengine.mapFile("mtable.abon",space,app);
+    if( !src.good() ) src = mdengine.mapFile("mtable.json",space,app);
+    if( !src.good() ) return false;
     auto& target = (space==Work)?mwork:(space==Root)?mroot:mapps[app];
-    return loadModescTable(target,table);
+    return loadModescTable(target,src.data(),src.size());
 }
 
 bool Manager::loadModescTable( map<string,modescs>& apps ) {
@@ -155,57 +353,121 @@ bool Manager::loadModescTable( map<string,modescs>& apps ) {
     return count == 0;
 }
 
-bool Manager::loadModescTable( modescs& descs, Jsonz table ) {
-
-    if( !table.is(JObject) ) return false;
-    if( !table["app-namme"].is(JString) ) return false;
-    if( !table["descs"].is(JObject) ) return false;
-    if( !table["mtim"].is(JInteger) ) return false;
-
-    descs.aname = (string)table["name"];
-    descs.mtim = (int)table["mtim"];
-    bool error = false;
-    
-    table["descs"].foreach([&]( const string& k, Jsonz& v) {
-
-        $modesc ref;
-
-        if( !v["docs"].is(JArray) ) return error = true;
-        if( !v["deps"].is(JArray) ) return error = true;
+bool Manager::loadModescTable( modescs& descs, const char* data, size_t size ) {
+
+    /**
+     * 读取器按照嵌套深度识别模块描述符表的内容
+     *  深度1 : 模块描述符表,键为name,mtim,descs
+     *  深度2 : 模块描述符集合,键为模块名
+     *  深度3 : 模块描述符,键为docs,deps,stamp,face
+     *  深度4 : 源文档描述列表或依赖描述列表
+     *  深度5 : 源文档描述或依赖描述
+     */
+    struct reader : public Jsonz::handler {
+        mtrecord t;
+        int depth = 0;
+        bool indescs = false;
+        bool indesc = false;
+        int list = 0;               //1 : docs, 2 : deps
+        bool inelem = false;
+        string section;
+        string field;
+        string efield;
+        int mask = 0;
+        Dengine::vfd vfd;
+        mtrecord::dep dep;
+
+        mtrecord::desc& desc() {return t.descs.back();}
+
+        /** 处理出现在容器位置上的标量,返回是否已被处理 */
+        bool misplaced() {
+            if( indescs and depth == 2 ) t.descs.emplace_back();
+            else if( list and depth == 4 ) desc().bad = true;
+            else return false;
+            return true;
+        }
 
-        for( auto& desc : descs )
-            if( desc->program == descs.aname and desc->name == k ) {ref = desc;break;}
-        if( ref == nullptr ) descs << (ref = new modesc(*this,k,descs.aname));
-        
-        v["docs"].foreach( [&](Jsonz& doc) {
-            Dengine::vfd vfd;
-            if( doc.test<JInteger>("space","mtim","size") and doc.test<JString>("name") ) {
-                vfd.name = doc["name"];
-                vfd.space = (int)doc["space"];
-                vfd.mtim = (int)doc["mtim"];
-                vfd.size = (int)doc["size"]; 
-                ref->appendDocument(vfd);
-            } else {
-                error = true;
+        bool key( std::string_view k )override {
+            if( depth == 1 ) section.assign(k.data(),k.size());
+            else if( indescs and depth == 2 ) field.assign(k.data(),k.size());
+            else if( indesc and depth == 3 ) field.assign(k.data(),k.size());
+            else if( inelem and depth == 5 ) efield.assign(k.data(),k.size());
+            return true;
+        }
+        bool null()override {misplaced();return true;}
+        bool boolean( bool )override {misplaced();return true;}
+        bool real( double )override {misplaced();return true;}
+        bool integer( long long v )override {
+            if( misplaced() ) return true;
+            if( depth == 1 and section == "mtim" ) {t.mtim = v;t.hmtim = true;}
+            else if( inelem and list == 1 ) {
+                if( efield == "space" ) {vfd.space = (vspace)v;mask |= 1;}
+                else if( efield == "mtim" ) {vfd.mtim = v;mask |= 2;}
+                else if( efield == "size" ) {vfd.size = v;mask |= 4;}
             }
             return true;
-        });
-
-        v["deps"].foreach( [&](Jsonz& dep) {
-            $depdesc m = new depdesc;
-            if( !dep.is(JObject) ) return error = true;
-            if( dep["name"].is(JString) ) m->name = token(dep["name"]); else return error = true;
-            if( dep["from"].is(JString) ) m->mfrom = token(dep["from"]);
-            if( dep["alias"].is(JString) ) m->alias = token(dep["alias"]);
-            m->self = ref;
-            ref->deps << m;
+        }
+        bool text( std::string_view v )override {
+            if( misplaced() ) return true;
+            if( depth == 1 and section == "name" ) {t.name.assign(v.data(),v.size());t.hname = true;}
+            else if( indesc and depth == 3 and field == "stamp" ) {desc().stamp.assign(v.data(),v.size());desc().hstamp = true;}
+            else if( indesc and depth == 3 and field == "face" ) {desc().face.assign(v.data(),v.size());desc().hface = true;}
+            else if( inelem and list == 1 and efield == "name" ) {vfd.name.assign(v.data(),v.size());mask |= 8;}
+            else if( inelem and list == 2 and efield == "name" ) {dep.name.assign(v.data(),v.size());mask |= 1;}
+            else if( inelem and list == 2 and efield == "from" ) dep.from.assign(v.data(),v.size());
+            else if( inelem and list == 2 and efield == "alias" ) dep.alias.assign(v.data(),v.size());
             return true;
-        });
-
-        return true;
-    });
+        }
+        bool openObject()override {
+            depth += 1;
+            if( depth == 2 and section == "descs" ) {
+                indescs = t.hdescs = true;
+            } else if( indescs and depth == 3 ) {
+                indesc = true;
+                t.descs.emplace_back();
+                desc().name = field;
+            } else if( list and depth == 5 ) {
+                inelem = true;
+                mask = 0;
+                vfd = Dengine::vfd();
+                dep = mtrecord::dep();
+            }
+            return true;
+        }
+        bool closeObject()override {
+            if( inelem and depth == 5 ) {
+                inelem = false;
+                if( list == 1 and mask == 15 ) desc().docs.push_back(vfd);
+                else if( list == 2 and mask == 1 ) desc().deps.push_back(move(dep));
+                else desc().bad = true;
+            } else if( indesc and depth == 3 ) {
+                indesc = false;
+            } else if( indescs and depth == 2 ) {
+                indescs = false;
+            }
+            depth -= 1;
+            return true;
+        }
+        bool openArray()override {
+            misplaced();
+            depth += 1;
+            if( indesc and depth == 4 and field == "docs" ) {list = 1;desc().hdocs = true;}
+            else if( indesc and depth == 4 and field == "deps" ) {list = 2;desc().hdeps = true;}
+            return true;
+        }
+        bool closeArray()override {
+            if( list and depth == 4 ) list = 0;
+            depth -= 1;
+            return true;
+        }
+    } rd;
 
-    return !error;
+    if( JsonzView::probe(data,size) ) {
+        if( !JsonzView::fromAbon(data,size).parse(rd) ) return false;
+    } else if( !Jsonz::parse(data,size,rd) ) {
+        return false;
+    }
+    return install(*this,descs,rd.t);
 }
 
 bool Manager::buildModescTable( Lengine::logr& log, vspace  space, const string& app ) {
@@ -219,16 +481,21 @@ bool Manager::buildModescTable( Lengine::logr& log, vspace  space, const string&
     modescs finally;
     finally.aname = (space==Work)?appname:(space==Root)?"alioth":app;
     finally.mtim = (int)time(nullptr);
+    auto& targ = (space==Work)?mwork:(space==Root)?mroot:mapps[app];
 
-    auto build = [&]( Dengine::vfd vfd ) {
-        auto is = mdengine.getIs(vfd);
-        if( !is ) return;
-        Xengine lexical;
+    auto scan = [&]( const Dengine::vfd& vfd, $ModuleSignature& st, Lengine::logs& logr ) {
+        auto src = mdengine.mapFile(vfd);
+        if( !src.good() ) return;
+        Xengine lexical(logr.path);
         Yengine syntax;
 
-        auto tis = lexical.parseModuleSignature(*is);
-        auto logr = mlengine.fordoc(mdengine.getPath(vfd));
-        auto st = syntax.detectModuleSignature(tis,logr);
+        auto tis = lexical.parseModuleSignature(src.data(),src.size());
+        if( !tis[0].bo ) {logr(Lengine::E111,logr.path);return;}
+        if( symbol::exhausted() ) {logr(Lengine::E112,logr.path);return;}
+        st = syntax.detectModuleSignature(tis,logr);
+    };
+
+    auto build = [&]( const Dengine::vfd& vfd, $ModuleSignature st, Lengine::logs& logr ) {
         if( !st ) {
             if( isalioth(vfd.name) ) log << logr;
             return;
@@ -237,7 +504,15 @@ bool Manager::buildModescTable( Lengine::logr& log, vspace  space, const string&
         $modesc ref;
         for( auto& mod : finally ) 
             if( mod->name == st->name ) ref = mod;
-        if( ref == nullptr ) finally << (ref = new modesc(*this,st->name,vfd.detectApp(appname)));
+        if( ref == nullptr ) {
+            //沿用旧表中的同名描述符,使其保留的语法树能被增量构建复用
+            auto prog = vfd.detectApp(appname);
+            for( auto& old : targ ) 
+                if( old->name == st->name and old->program == prog ) ref = old;
+            if( ref ) ref->clearDocuments();
+            else ref = new modesc(*this,st->name,prog);
+            finally << ref;
+        }
 
         for( auto& d : st->deps ) {
             d->self = ref;
@@ -248,13 +523,16 @@ bool Manager::buildModescTable( Lengine::logr& log, vspace  space, const string&
     };
 
     bool lastest = true;
-    auto& targ = (space==Work)?mwork:(space==Root)?mroot:mapps[app];
     Dengine::vfds todo = mdengine.enumFile(space|Src,"",app);
     for( auto& vfd : mdengine.enumFile(space|Inc,"",app) ) todo << move(vfd);
     for( auto& fd : todo ) if( fd.mtim > targ.mtim ) {lastest = false;break;}
 
     if( !lastest ) {
-        for( auto& td : todo ) build(td);
+        vector<$ModuleSignature> sts(todo.size());
+        vector<Lengine::logs> logrs;
+        for( auto& td : todo ) logrs.push_back(mlengine.fordoc(mdengine.getPath(td)));
+        parallel(todo.size(),[&]( size_t i ){ scan(todo[i],sts[i],logrs[i]); });
+        for( size_t i = 0; i < todo.size(); i++ ) build(todo[i],sts[i],logrs[i]);
         targ = finally;
     }
 
@@ -262,17 +540,19 @@ bool Manager::buildModescTable( Lengine::logr& log, vspace  space, const string&
 }
 
 bool Manager::printModescTable( vspace space, const string& app ) {
-    Jsonz table;
+    JsonzDocument doc;
+    JsonzDocument::scope active(&doc);
+    auto& table = doc.root();
     if( !printModescTable(table,space,app) ) return false;
     bool error = false;
     if( space == Work or space == Root or !app.empty() ) {
-        auto os = mdengine.getOs("mtable.json",space,app);
+        auto os = mdengine.getOs("mtable.abon",space,app);
         if( !os ) return false;
-        *os << table.toJson();
+        table.toAbon(*os,2);
     } else table.foreach([&](const string& aname, Jsonz& t) {
-        auto os = mdengine.getOs("mtable.json",Apps,aname);
+        auto os = mdengine.getOs("mtable.abon",Apps,aname);
         if( !os ) return error = true;
-        *os << t.toJson();
+        t.toAbon(*os,2);
         return true;
     });
     
@@ -312,7 +592,10 @@ bool Manager::printModescTable( Jsonz& table, vspace space, const string& app )
     table["descs"] = Jsonz(JObject);
     for( auto& mod : *targ ) {
         Jsonz& desc = table["descs"][mod->name] =  Jsonz(JObject);
-        desc["deps"] = desc["docs"] = Jsonz(JArray);
+        desc["deps"] = Jsonz(JArray);
+        desc["docs"] = Jsonz(JArray);
+        if( !mod->objstamp.empty() ) desc["stamp"] = mod->objstamp;
+        if( !mod->face.empty() ) desc["face"] = mod->face;
         
         for(auto& fd : mod->getDocuments(false) ) {
             Jsonz fdesc = JObject;
@@ -343,58 +626,57 @@ void Manager::specifyModule( const string& name ) {
 
 bool Manager::Build( const BuildType type, Lengine::logr& log ) {//测试内容
 
-    loadModescTable(Work);
-    loadModescTable(Root);
-    loadModescTable(Apps);
-    buildModescTable(log,Work);
-    buildModescTable(log,Root);
-    buildModescTable(log,Apps);
+    auto trace = mpengine.span("build","manager",appname);
+
+    {
+        auto measure = mpengine.measure("table");
+        if( !mloaded ) {
+            loadModescTable(Work);
+            loadModescTable(Root);
+            loadModescTable(Apps);
+            mloaded = true;
+        }
+        buildModescTable(log,Work);
+        buildModescTable(log,Root);
+        buildModescTable(log,Apps);
+    }
 
     missing.clear();
     multing.clear();
     urching.clear();
+    if( !msengine or !mresident ) msengine = make_unique<Sengine>(&mpengine);
+    msengine->clearLog();
 
     bool bfine = true;
     bool bentry = false;
 
     if( mnames.size() == 0 ) for( auto desc : mwork ) mnames.push_back(desc->name);
+    list<string> names;
+    names.swap(mnames);
 
     modescs descs;
-    for( auto& mname : mnames ) {
+    for( auto& mname : names ) {
         auto res = completDependencies(mname,log,descs);
         if( res < 0 ) bfine = false;
     }
-    for( auto& desc : descs ) if( desc->constructAbstractSyntaxTree( log ) ) {
-        if( bfine ) 
-            if( 2 == msengine.loadModuleDefinition(desc) ) 
-                bentry = true;
-    } else {
-        bfine = false;
-    }
-
+    for( auto& desc : descs ) if( !desc->constructAbstractSyntaxTree( log ) ) bfine = false;
     if( !bfine ) return false;
-
-    if( !msengine.performDefinitionSemanticValidation() ) {
-        log += msengine.getLog();
-        return false;
-    }
-
-    vector<string> args;
-    char cmd[128];
-    if( type != SYNTAXCHECK and appname.size() ) {
-        if( bentry ) {
-            args.push_back("ld");
-            args.push_back("-o");
-            args.push_back(mdengine.getPath("",Work|Bin) + appname);
-            args.push_back(mdengine.getPath("alioth.o", Root|Obj));
-            if( whichCmd(cmd,"ld") ) {cout << "cannot find linker \"ld\"" << endl;bfine = false;}
-        } else {
-            args.push_back("ar");
-            args.push_back("-rcs");
-            args.push_back(mdengine.getPath("",Work|Arc) + "lib" + appname + ".a");
-            if( whichCmd(cmd,"ar") ) {cout << "cannot find command \"ar\"" << endl;bfine = false;}
-        }
-    }
+    descs.survey();
+
+    /**
+     * 需要翻译的模块,以及所有模块的目标文件
+     * 源码与依赖的对外摘要都没有变化,且目标文件存在的模块直接复用目标文件
+     */
+    struct job {
+        $modesc         desc;
+        Dengine::vfdm   fd;
+        string          stamp;
+        bool            fine;
+        string          image;
+    };
+    vector<job> jobs;
+    vector<string> objs;
+    map<string,string> images;
 
     for( auto desc : descs ) {
         
@@ -403,28 +685,159 @@ bool Manager::Build( const BuildType type, Lengine::logr& log ) {//测试内容
         fd.name = desc->name+".o";
         fd.space = Obj;
         fd.space |= desc->program == this->appname?Work:desc->program == "alioth"?Root:Apps;
-        args.push_back(mdengine.getPath(fd));
-
-        for( auto imname = mnames.begin(); imname != mnames.end(); imname++  ) if( auto& mname = *imname; mname == desc->name ) {
-            mnames.erase(imname);
-            auto unit = msengine.performImplementationSemanticValidation(desc,mdengine);
-            if( !unit ) bfine = false;
-            else if( type != SYNTAXCHECK )
-                if( !msengine.triggerBackendTranslation(unit, fd, mdengine) ) 
-                    bfine = false;
+        objs.push_back(mdengine.getPath(fd));
+
+        for( auto imname = names.begin(); imname != names.end(); imname++  ) if( auto& mname = *imname; mname == desc->name ) {
+            names.erase(imname);
+            auto stamp = desc->stamp();
+            //语法检查不产生目标文件,不能影响目标文件的摘要
+            if( type == MACHINECODE ) {
+                if( Dengine::vfd ofd; stamp == desc->objstamp and mdengine.statFile(fd.name,fd.space,fd.app,ofd) ) break;
+                desc->objstamp.clear();
+            }
+            jobs.push_back((job){desc,fd,stamp,false,""});
             break;
         }
     }
 
-    log += msengine.getLog();
-    if( type != SYNTAXCHECK and appname.size() and bfine and descs.size() and fork() == 0 ) {
-        vector<const char*> sargs;
-        for( auto& arg : args ) sargs.push_back(arg.c_str()); sargs.push_back(nullptr);
-        execv( cmd, (char*const*)&sargs[0] );
+    /**
+     * 多个模块需要翻译时,每个工作线程拥有独立的语义引擎,也就拥有独立的llvm上下文环境和目标机器
+     * 工作线程的语义引擎装载原始语法树的副本,副本在主语义引擎装载语法树之前准备,并在主线程中闭合依赖
+     */
+    size_t workers = min((size_t)mjobs,jobs.size());
+    vector<map<$modesc,chainz<$ModuleGranule>>> replicas(workers > 1 ? workers : 0);
+    for( auto& replica : replicas ) {
+        auto measure = mpengine.measure("replicate");
+        Yengine yeng;
+        for( auto& desc : descs ) for( auto syn : desc->pristine ) {
+            auto copy = yeng.duplicateSyntaxTree(syn);
+            for( auto d : copy->signature->deps ) {
+                d->self = desc;
+                closeUpDependency(d);
+            }
+            replica[desc] << copy;
+        }
+    }
+
+    /**
+     * 源码发生变化的模块连同依赖它们的模块一起被卸载
+     * 未装载的模块重新准备语法树并装载,仍然装载着的模块直接复用
+     */
+    for( auto& desc : descs ) if( desc->synhash != desc->srchash ) msengine->unloadModuleDefinition(desc);
+    for( auto& desc : descs ) {
+        auto measure = mpengine.measure("load-definition",desc->name);
+        if( !msengine->hasModuleDefinition(desc) ) desc->prepareSyntaxTrees();
+        switch( msengine->loadModuleDefinition(desc) ) {
+            case 0: msengine->unloadModuleDefinition(desc); break;
+            case 2: bentry = true; break;
+        }
+    }
+
+    if( !msengine->performDefinitionSemanticValidation() ) {
+        log += msengine->getLog();
+        return false;
+    }
+
+    if( replicas.empty() ) for( auto& j : jobs ) {
+        Sengine::ModuleTrnsUnit unit;
+        {
+            auto measure = mpengine.measure("implementation-sema",j.desc->name);
+            unit = msengine->performImplementationSemanticValidation(j.desc,mdengine);
+        }
+        //实现语义分析会就地修改语法树,下次构建时模块需要从原始语法树重新装载
+        j.desc->synhash.clear();
+        j.fine = unit and (type == SYNTAXCHECK or msengine->triggerBackendTranslation(unit,j.fd,mdengine,&j.image));
+    } else {
+
+        /**
+         * 模块在它所有需要翻译的依赖完成之后才被调度
+         * 若循环依赖使得没有模块就绪,且没有模块正在翻译,则任选一个尚未开始的模块打破循环
+         */
+        size_t count = jobs.size(), pending = count, running = 0;
+        map<modesc*,size_t> index;
+        vector<size_t> waiting(count,0);
+        vector<vector<size_t>> dependents(count);
+        vector<bool> started(count,false);
+        deque<size_t> ready;
+        mutex mtx;
+        condition_variable cond;
+
+        for( size_t i = 0; i < count; i++ ) index[jobs[i].desc] = i;
+        for( size_t i = 0; i < count; i++ ) for( auto& dep : jobs[i].desc->deps ) {
+            if( auto it = index.find(dep->dest); it != index.end() and it->second != i ) {
+                waiting[i] += 1;
+                dependents[it->second].push_back(i);
+            }
+        }
+        for( size_t i = 0; i < count; i++ ) if( waiting[i] == 0 ) ready.push_back(i);
+
+        auto take = [&]( size_t& i ) {
+            unique_lock<mutex> lock(mtx);
+            cond.wait(lock,[&]{ return pending == 0 or !ready.empty() or running == 0; });
+            if( pending == 0 ) return false;
+            if( ready.empty() ) {
+                for( i = 0; started[i]; i++ );
+            } else {
+                i = ready.front();
+                ready.pop_front();
+            }
+            started[i] = true;
+            pending -= 1;
+            running += 1;
+            return true;
+        };
+        auto done = [&]( size_t i ) {
+            lock_guard<mutex> lock(mtx);
+            running -= 1;
+            for( auto d : dependents[i] ) if( --waiting[d] == 0 and !started[d] ) ready.push_back(d);
+            cond.notify_all();
+        };
+
+        vector<unique_ptr<Sengine>> engines;
+        for( size_t w = 0; w < workers; w++ ) engines.push_back(make_unique<Sengine>(&mpengine));
+        vector<thread> threads;
+        for( size_t w = 0; w < workers; w++ ) threads.emplace_back([&,w]{
+            auto& engine = *engines[w];
+            {
+                auto measure = mpengine.measure("replicate-definition");
+                if( !engine.replicate(replicas[w]) ) return;
+            }
+            //定义语义分析的日志已经由主语义引擎产生
+            engine.clearLog();
+            for( size_t i; take(i); done(i) ) {
+                auto& j = jobs[i];
+                Sengine::ModuleTrnsUnit unit;
+                {
+                    auto measure = mpengine.measure("implementation-sema",j.desc->name);
+                    unit = engine.performImplementationSemanticValidation(j.desc,mdengine);
+                }
+                j.fine = unit and (type == SYNTAXCHECK or engine.triggerBackendTranslation(unit,j.fd,mdengine,&j.image));
+            }
+        });
+        for( auto& t : threads ) t.join();
+        log += msengine->getLog();
+        msengine->clearLog();
+        for( auto& engine : engines ) log += engine->getLog();
+    }
+
+    for( auto& j : jobs ) {
+        if( !j.fine ) {bfine = false;continue;}
+        if( type == SYNTAXCHECK ) continue;
+        j.desc->objstamp = j.stamp;
+        images[mdengine.getPath(j.fd)] = move(j.image);
+    }
+
+    log += msengine->getLog();
+    if( type == SYNTAXCHECK or appname.empty() or !bfine or descs.size() == 0 ) return bfine;
+
+    auto measure = mpengine.measure("link");
+    if( bentry ) {
+        vector<string> args = {"ld.lld","-o",mdengine.getPath("",Work|Bin) + appname,mdengine.getPath("alioth.o", Root|Obj)};
+        args.insert(args.end(),objs.begin(),objs.end());
+        return linkExecutable(args,mresident);
+    } else {
+        return archiveObjects(mdengine.getPath("",Work|Arc) + "lib" + appname + ".a",objs,images);
     }
-    int st;
-    wait(&st);
-    return bfine and st == 0;
 }
 
 int Manager::completDependencies( const string& name, Lengine::logr& log, modescs& output ) {
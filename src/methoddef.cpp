@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+MethodDef::MethodDef():definition(cthing::MethodDef) {}
+
 bool MethodDef::is( cnode c )const {
     return c == METHODDEF or c == DEFINITION;
 }
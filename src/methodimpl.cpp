@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+MethodImpl::MethodImpl():implementation(cthing::MethodImpl) {}
+
 bool MethodImpl::is( cnode c )const {
     return c == METHODIMPL or c == IMPLEMENTATION;
 }
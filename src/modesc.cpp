@@ -5,10 +5,14 @@
 #include "manager.hpp"
 #include "xengine.hpp"
 #include "yengine.hpp"
+#include <algorithm>
+#include <vector>
+#include <set>
 
 namespace alioth {
 
 modesc::modesc( Manager& mana, const string& pname, const string& papp ):
+  thing(cthing::modesc),
   program(papp.empty()?mana.getAppName():papp),
   name(pname),
   manager(&mana){
@@ -18,6 +22,11 @@ modesc::~modesc() {
 
 }
 
+void modesc::clearDocuments() {
+    mdocs.clear();
+    deps.clear();
+}
+
 bool modesc::appendDocument( Dengine::vfd desc ) {
     desc.space &= 0x00FF;
     desc.app = program;
@@ -53,34 +62,176 @@ modescs& modescs::operator=( modescs&& an ) {
     return *this;
 }
 
+/**
+ * @function fingerprint : 计算接口指纹
+ * @desc :
+ *  在语法分析之前,扫描词法记号序列,将其他模块可见的记号累积到摘要中
+ *  顶层的方法实现和运算符实现只保留头部,其函数体被跳过
+ *  注释和空白被忽略
+ * @param ts : 词法记号序列
+ * @param hash : 摘要初始值
+ * @return uint64_t : 摘要
+ */
+static uint64_t fingerprint( const tokens& ts, uint64_t hash ) {
+    int depth = 0;
+    int skip = -1;
+    bool impl = false;
+    for( auto& t : ts ) {
+        if( t.is(VT::COMMENT,VT::SPACE) ) continue;
+        if( t.is(VT::OPENS) ) depth += 1;
+        else if( t.is(VT::CLOSES) ) depth -= 1;
+
+        if( skip >= 0 ) {
+            if( depth == skip ) skip = -1;
+            continue;
+        }
+        if( depth == 0 and t.is(VT::METHOD,VT::OPERATOR) ) impl = true;
+        else if( depth == 1 and impl and t.is(VT::OPENS) ) {
+            impl = false;
+            skip = 0;
+            continue;
+        }
+
+        int id = (int)t.id;
+        hash = digest(&id,sizeof(id),hash);
+        hash = digest((string)t,hash);
+    }
+    return hash;
+}
+
 bool modesc::constructAbstractSyntaxTree( Lengine::logr& log ) {
     if( mdocs.size() == 0 ) return false;
     bool error = false;
-    Xengine xeng;
-    Yengine yeng;
+    auto previous = pristine;
+    pristine.clear();
     auto& dengine = manager->getDocumentEngine();
-    
-    for( auto& doc : getDocuments() ) {
-        auto is = dengine.getIs(doc);
-        auto path = dengine.getPath(doc);
-        auto& lo = log.construct(-1,path);
-        if( !is ) {
-            lo(Lengine::E107,path,name,program);
-            error = true;
-            continue;
+    auto& pengine = manager->getPerformanceEngine();
+    uint64_t hash = digest(name);
+    uint64_t fhash = digest(name);
+
+    /**
+     * 每个文档的分析结果,文档之间相互独立,可以并行地分析
+     * 日志和旧的语法树在分派前按照文档顺序准备好,工作线程只接触属于自己的文档
+     */
+    struct result {
+        Dengine::vfd        doc;
+        Lengine::logs*      lo;
+        $ModuleGranule      old;
+        $ModuleGranule      ref;
+        uint64_t            hash;
+        uint64_t            fhash;
+        bool                good;
+    };
+    auto docs = getDocuments();
+    vector<result> results;
+    for( auto& doc : docs ) {
+        $ModuleGranule old = nullptr;
+        for( auto g : previous ) if( g->document == doc ) old = g;
+        results.push_back((result){doc,&log.construct(-1,dengine.getPath(doc)),old,nullptr,0,0,false});
+    }
+
+    manager->parallel(results.size(),[&]( size_t i ) {
+        auto& res = results[i];
+        auto& lo = *res.lo;
+        auto trace = pengine.span(lo.path,"document",name);
+        auto src = dengine.mapFile(res.doc);
+        if( !src.good() ) {
+            lo(Lengine::E107,lo.path,name,program);
+            return;
+        }
+
+        res.good = true;
+        res.hash = digest(src.view(),digest(res.doc.name));
+        auto lmeasure = pengine.measure("lex",name);
+        lmeasure.count(src.size());
+        Xengine::edit change;
+        auto ts = manager->lexDocument(lo.path,src.view(),&change);
+        lmeasure.stop();
+        if( !ts[0].bo ) {lo(Lengine::E111,lo.path);return;}
+        if( symbol::exhausted() ) {lo(Lengine::E112,lo.path);return;}
+        res.fhash = fingerprint(ts,0);
+        auto pmeasure = pengine.measure("parse",name);
+        Yengine yeng;
+        res.ref = change.b >= 0 and res.old ? yeng.reconstructSyntaxTree(res.old,ts,change,lo) : yeng.constructSyntaxTree(ts,lo);
+    });
+
+    for( auto& res : results ) {
+        if( !res.good ) {error = true;continue;}
+        hash = digest(&res.hash,sizeof(res.hash),hash);
+        fhash = digest(&res.fhash,sizeof(res.fhash),fhash);
+        if( res.ref == nullptr ) {error = true;continue;}
+
+        res.ref->desc = this;
+        res.ref->document = res.doc;
+        pristine << res.ref;
+    }
+
+    /**
+     * 依赖表可能引用驻留在旧语法树中的依赖描述符,旧语法树在此之后被释放
+     * 所以依赖表改为引用新语法树中的依赖描述符,并重新闭合
+     */
+    if( deps.size() and deps[0]->resident() ) {
+        deps.clear();
+        for( auto syn : pristine ) for( auto d : syn->signature->deps ) {
+            d->self = this;
+            manager->closeUpDependency(d);
+            deps << d;
         }
-        
-        auto ts = xeng.parseSourceCode(*is);
-        auto ref = yeng.constructSyntaxTree(ts,lo);
-        if( ref == nullptr ) {error = true;continue;}
-
-        ref->desc = this;
-        ref->document = doc;
-        syntrees << ref;
     }
 
+    srchash = hexdigest(hash);
+    face = hexdigest(fhash);
     return !error;
 }
 
+void modesc::prepareSyntaxTrees() {
+    if( manager->isResident() ) {
+        Yengine yeng;
+        syntrees.clear();
+        for( auto syn : pristine ) syntrees << yeng.duplicateSyntaxTree(syn);
+    } else {
+        syntrees = pristine;
+    }
+    synhash = srchash;
+}
+
+/**
+ * 以访问集合遍历依赖闭包,每个依赖只被访问一次,循环依赖也能终止
+ * 闭包按模块排序后参与摘要,使摘要与遍历顺序无关
+ */
+static uint64_t closure( const modesc& mod, uint64_t hash ) {
+    std::set<const modesc*> visited = {&mod};
+    std::vector<const modesc*> pending = {&mod};
+    std::vector<const modesc*> reach;
+    while( !pending.empty() ) {
+        auto m = pending.back();
+        pending.pop_back();
+        for( auto& dep : m->deps ) if( dep->dest and visited.insert(dep->dest).second ) {
+            reach.push_back(dep->dest);
+            pending.push_back(dep->dest);
+        }
+    }
+
+    std::sort(reach.begin(),reach.end(),[]( const modesc* a, const modesc* b ) {
+        return a->program != b->program ? a->program < b->program : a->name < b->name;
+    });
+    for( auto m : reach ) {
+        hash = digest(m->program,hash);
+        hash = digest(m->name,hash);
+        hash = digest(m->face,hash);
+    }
+    return hash;
+}
+
+std::string modesc::stamp()const {
+    uint64_t hash = digest(srchash);
+    for( auto& dep : deps ) if( dep->dest ) hash = digest(dep->dest->surface,hash);
+    return hexdigest(hash);
+}
+
+void modescs::survey() {
+    for( auto& mod : *this ) mod->surface = hexdigest(closure(*mod,digest(mod->face)));
+}
+
 }
 #endif
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+module::module():ClassDef(cthing::module) {}
+
 bool module::is( cnode n ) const {
     return n == MODULE or n == DEFINITION;
 }
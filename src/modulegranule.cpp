@@ -7,6 +7,8 @@
 
 namespace alioth {
 
+ModuleGranule::ModuleGranule():node(cthing::ModuleGranule) {}
+
 bool ModuleGranule::is( cnode c ) const {
     return c == GRANULE;
 }
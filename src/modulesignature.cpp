@@ -5,7 +5,7 @@
 
 namespace alioth {
 
-ModuleSignature::ModuleSignature( const std::string& pname ) : name(pname) {
+ModuleSignature::ModuleSignature( const std::string& pname ) : node(cthing::ModuleSignature), name(pname) {
 
 }
 
@@ -6,6 +6,8 @@
 
 namespace alioth {
 
+nameuc::nameuc():thing(cthing::nameuc) {}
+
 nameuc::atom::operator bool()const {
     if( !name.is(VT::LABEL) ) return false;
     for( auto& t : tmpl ) if( !t ) return false;
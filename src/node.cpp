@@ -6,7 +6,7 @@
 
 namespace alioth {
 
-node::node( $scope sc ):mscope(sc) {}
+node::node( cthing c, $scope sc ):thing(c),mscope(sc) {}
 
 bool node::setScope( $scope sc ) {
     if( mscope ) return false;
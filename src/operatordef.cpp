@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+OperatorDef::OperatorDef():definition(cthing::OperatorDef) {}
+
 bool OperatorDef::is( cnode n )const {
     return n == OPERATORDEF or n == DEFINITION;
 }
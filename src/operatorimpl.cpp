@@ -5,6 +5,8 @@
 
 namespace alioth {
 
+OperatorImpl::OperatorImpl():implementation(cthing::OperatorImpl) {}
+
 bool OperatorImpl::is( cnode n )const {
     return n == OPERATORIMPL or n == IMPLEMENTATION;
 }
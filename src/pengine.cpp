@@ -0,0 +1,179 @@
+#ifndef __pengine_cpp__
+#define __pengine_cpp__
+
+#include "pengine.hpp"
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+
+namespace alioth {
+
+Pengine::scope::scope( Pengine* pengine, const string& phase, const string& module, bool report, const string& cat ):
+    mpengine(pengine),mreport(report),mwall(0),mcpu(0),mrss(0),mbytes(0) {
+    if( mpengine ) mreport = mreport and mpengine->enabled();
+    if( !mpengine or (!mreport and !mpengine->tracing()) ) {
+        mpengine = nullptr;
+        return;
+    }
+    mphase = phase;
+    mmodule = module;
+    mcat = cat;
+    now(mwall,mcpu,mrss);
+}
+
+Pengine::scope::scope( scope&& an ):
+    mpengine(an.mpengine),mphase(move(an.mphase)),mmodule(move(an.mmodule)),mcat(move(an.mcat)),mreport(an.mreport),
+    mwall(an.mwall),mcpu(an.mcpu),mrss(an.mrss),mbytes(an.mbytes) {
+    an.mpengine = nullptr;
+}
+
+Pengine::scope::~scope() {
+    stop();
+}
+
+void Pengine::scope::stop() {
+    if( !mpengine ) return;
+    double wall, cpu;
+    long rss;
+    now(wall,cpu,rss);
+    if( mpengine->tracing() ) 
+        mpengine->commit((event){mphase,move(mcat),mmodule,(mwall-mpengine->mepoch)*1e3,(wall-mwall)*1e3,tid()});
+    if( mreport ) 
+        mpengine->commit((record){move(mphase),move(mmodule),wall-mwall,cpu-mcpu,rss-mrss,mbytes});
+    mpengine = nullptr;
+}
+
+void Pengine::scope::count( long bytes ) {
+    mbytes += bytes;
+}
+
+Pengine::Pengine():menabled(false),mtracing(false) {
+    double cpu;
+    long rss;
+    now(mepoch,cpu,rss);
+}
+
+void Pengine::enable( bool e ) {
+    menabled = e;
+}
+
+bool Pengine::enabled()const {
+    return menabled;
+}
+
+void Pengine::trace( bool t ) {
+    mtracing = t;
+}
+
+bool Pengine::tracing()const {
+    return mtracing;
+}
+
+Pengine::scope Pengine::measure( const string& phase, const string& module ) {
+    return scope(this,phase,module);
+}
+
+Pengine::scope Pengine::span( const string& name, const string& cat, const string& module ) {
+    return scope(this,name,module,false,cat);
+}
+
+void Pengine::commit( record rec ) {
+    lock_guard<mutex> lock(mmutex);
+    mrecords << move(rec);
+}
+
+void Pengine::commit( event evt ) {
+    lock_guard<mutex> lock(mmutex);
+    mevents << move(evt);
+}
+
+void Pengine::clear() {
+    lock_guard<mutex> lock(mmutex);
+    mrecords.clear();
+    mevents.clear();
+}
+
+Jsonz Pengine::report() {
+    lock_guard<mutex> lock(mmutex);
+    Jsonz ret = JObject;
+    ret["phases"] = Jsonz(JObject);
+    ret["modules"] = Jsonz(JObject);
+
+    auto accumulate = [](Jsonz& sum, const record& rec) {
+        if( !sum.is(JObject) ) {
+            sum = Jsonz(JObject);
+            sum["wall-ms"] = 0.0;
+            sum["cpu-ms"] = 0.0;
+            sum["rss-kb"] = 0;
+            sum["count"] = 0;
+        }
+        sum["wall-ms"] = (double)sum["wall-ms"] + rec.wall;
+        sum["cpu-ms"] = (double)sum["cpu-ms"] + rec.cpu;
+        sum["rss-kb"] = (int)sum["rss-kb"] + (int)rec.rss;
+        sum["count"] = (int)sum["count"] + 1;
+        if( rec.bytes ) {
+            sum["bytes"] = (double)sum["bytes"] + rec.bytes;
+            if( (double)sum["wall-ms"] > 0 ) sum["mb-per-s"] = (double)sum["bytes"] / 1e3 / (double)sum["wall-ms"];
+        }
+    };
+
+    for( auto& rec : mrecords ) {
+        accumulate(ret["phases"][rec.phase],rec);
+        if( rec.module.empty() ) continue;
+        auto& mod = ret["modules"][rec.module];
+        if( !mod.is(JObject) ) mod = Jsonz(JObject);
+        accumulate(mod[rec.phase],rec);
+    }
+
+    return ret;
+}
+
+Jsonz Pengine::traceEvents() {
+    lock_guard<mutex> lock(mmutex);
+    Jsonz ret = JObject;
+    auto& evts = ret["traceEvents"] = Jsonz(JArray);
+    int pid = getpid();
+
+    for( auto& evt : mevents ) {
+        Jsonz e = JObject;
+        e["name"] = evt.name;
+        e["cat"] = evt.cat;
+        e["ph"] = "X";
+        e["ts"] = evt.ts;
+        e["dur"] = evt.dur;
+        e["pid"] = pid;
+        e["tid"] = (int)evt.tid;
+        if( !evt.module.empty() ) {
+            e["args"] = Jsonz(JObject);
+            e["args"]["module"] = evt.module;
+        }
+        evts.insert(move(e),-1);
+    }
+
+    ret["displayTimeUnit"] = "ms";
+    return ret;
+}
+
+double Pengine::epoch()const {
+    return mepoch;
+}
+
+long Pengine::tid() {
+    return syscall(SYS_gettid);
+}
+
+void Pengine::now( double& wall, double& cpu, long& rss ) {
+    timespec ts;
+    rusage ru;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    wall = ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID,&ts);
+    cpu = ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+    getrusage(RUSAGE_SELF,&ru);
+    rss = ru.ru_maxrss;
+}
+
+}
+
+#endif
@@ -383,7 +383,8 @@ bool Sengine::performDefinitionSemanticValidation( $OperatorDef opdef ) {
 }
 
 bool Sengine::performImplementationSemanticValidation( $MethodImpl method ) {
-    
+    auto trace = Pengine::scope(mpengine,method->name,mcurmod->getModuleIdentifier(),false,"method");
+
     auto def = ($MethodDef)requestPrototype(($implementation)method);
     if( !def ) {
         mlogrepo(method->getDocPath())(Lengine::E2029,method->name);
@@ -428,6 +429,7 @@ bool Sengine::performImplementationSemanticValidation( $MethodImpl method ) {
 }
 
 bool Sengine::performImplementationSemanticValidation( $OperatorImpl oper ) {
+    auto trace = Pengine::scope(mpengine,oper->name,mcurmod->getModuleIdentifier(),false,"method");
 
     auto def = requestPrototype(($implementation)oper);
     if( !def ) {
@@ -640,7 +642,7 @@ $imm Sengine::processMemberExpression( $ExpressionImpl impl, IRBuilder<>& builde
         if( !def ) {mlogrepo(impl->getDocPath())(Lengine::E2055,impl->sub[0]->phrase,impl->mean);return;}
 
         for( auto d : type->is(typeuc::EntityType)?def->metadefs:def->instdefs )
-            if( (string)d->name == (string)name ) {
+            if( d->name.sym() == name.sym() ) {
                 if( auto ad = ($AttrDef)d; ad ) {
                     auto gep = builder.CreateStructGEP( mnamedT[generateGlobalUniqueName(($node)d,Meta)], v->asaddress(builder,*this), ad->offset );
                     ret << imm::element(gep,ad->proto,v);
@@ -650,7 +652,7 @@ $imm Sengine::processMemberExpression( $ExpressionImpl impl, IRBuilder<>& builde
                     if( !fp ) fp = Function::Create( (FunctionType*)mnamedT[fs], GlobalValue::ExternalLinkage, fs, mcurmod.get() );
                     ret << imm::function(fp,md,v);
                 }
-            } else if( auto od = ($OperatorDef)d; od and od->name.is(VN::OPL_MEMBER) and (string)od->subtitle == (string)name ) {
+            } else if( auto od = ($OperatorDef)d; od and od->name.is(VN::OPL_MEMBER) and od->subtitle.sym() == name.sym() ) {
                 if( pos != LeftOfAssign and od->size() != 0 ) continue;
                 if( pos == LeftOfAssign and od->size() == 0 ) continue;
                 auto fp = executableEntity(($node)od);
@@ -729,10 +731,11 @@ $imm Sengine::processValueExpression( $ExpressionImpl impl, IRBuilder<>& builder
             );
         } break;
         case VT::iINTEGERb: {
-            auto i = std::stoll(string(impl->mean.tx.begin()+2,impl->mean.tx.end()),nullptr,2);
+            string tx = impl->mean;
+            auto i = std::stoll(tx.substr(2),nullptr,2);
             $typeuc type = nullptr;
             Value* value = nullptr;
-            if( auto len = impl->mean.tx.length() - 2;
+            if( auto len = tx.length() - 2;
                 len <= 8 ) {type = typeuc::GetBasicDataType(typeuc::Uint8);value = builder.getInt8(i);}
                 else if( len <= 16 ) {type = typeuc::GetBasicDataType(typeuc::Uint16);value = builder.getInt16(i);}
                 else if( len <= 32 ) {type = typeuc::GetBasicDataType(typeuc::Uint32);value = builder.getInt32(i);}
@@ -742,10 +745,11 @@ $imm Sengine::processValueExpression( $ExpressionImpl impl, IRBuilder<>& builder
             return imm::instance( value, proto );
         } break;
         case VT::iINTEGERh: {
-            auto i = std::stoll(string(impl->mean.tx.begin()+2,impl->mean.tx.end()),nullptr,16);
+            string tx = impl->mean;
+            auto i = std::stoll(tx.substr(2),nullptr,16);
             $typeuc type = nullptr;
             Value* value = nullptr;
-            if( auto len = impl->mean.tx.length() - 2;
+            if( auto len = tx.length() - 2;
                 len <= 2 ) {type = typeuc::GetBasicDataType(typeuc::Uint8);value = builder.getInt8(i);}
                 else if( len <= 4 ) {type = typeuc::GetBasicDataType(typeuc::Uint16);value = builder.getInt16(i);}
                 else if( len <= 8 ) {type = typeuc::GetBasicDataType(typeuc::Uint32);value = builder.getInt32(i);}
@@ -755,10 +759,11 @@ $imm Sengine::processValueExpression( $ExpressionImpl impl, IRBuilder<>& builder
             return imm::instance( value, proto );
         } break;
         case VT::iINTEGERo: {
-            auto i = std::stoll(string(impl->mean.tx.begin()+2,impl->mean.tx.end()),nullptr,8);
+            string tx = impl->mean;
+            auto i = std::stoll(tx.substr(2),nullptr,8);
             $typeuc type = nullptr;
             Value* value = nullptr;
-            if( auto len = impl->mean.tx.length() - 2;
+            if( auto len = tx.length() - 2;
                 len <= 3 ) {type = typeuc::GetBasicDataType(typeuc::Uint8);value = builder.getInt8(i);}
                 else if( len <= 6 ) {type = typeuc::GetBasicDataType(typeuc::Uint16);value = builder.getInt16(i);}
                 else if( len <= 12 ) {type = typeuc::GetBasicDataType(typeuc::Uint32);value = builder.getInt32(i);}
@@ -768,7 +773,7 @@ $imm Sengine::processValueExpression( $ExpressionImpl impl, IRBuilder<>& builder
             return imm::instance( value, proto );
         } break;
         case VT::iFLOAT: {
-            auto i = std::stod(impl->mean.tx);
+            auto i = std::stod(impl->mean);
             auto value = ConstantFP::get(builder.getContext(), APFloat(i));
             $typeuc type = typeuc::GetBasicDataType(value->getType()->isDoubleTy()?typeuc::Float64:typeuc::Float32);
             auto proto = eproto::MakeUp(impl->getScope(),OBJ,type);
@@ -1539,18 +1544,18 @@ everything Sengine::request( const nameuc& name, Len len, $scope sc ) {
 
     if( !sc ) sc = name.getScope();
     if( !sc or name.size() == 0 ) return {};
-    auto sname = (string)name[0].name;
+    auto sname = name[0].name.sym();
     everything res;
 
     function<everything(const nameuc&,$scope)> lookupInternal = [&]( const nameuc& fn, $scope fsc ) -> everything {
-        auto fsname = (string)fn[0].name;
+        auto fsname = fn[0].name.sym();
         if( auto mdef = ($module)fsc; mdef ) {
-            for( auto in : mdef->internal + mdef->external ) if( (string)in->name == fsname ) {
+            for( auto in : mdef->internal + mdef->external ) if( in->name.sym() == fsname ) {
                 if( fn.size() == 1 ) res << (anything)in;
                 else return lookupInternal( fn%1, in );
             }
         } else if( auto cdef = ($ClassDef)fsc; cdef ) {
-            for( auto in : cdef->internal ) if( (string)in->name == fsname ) {
+            for( auto in : cdef->internal ) if( in->name.sym() == fsname ) {
                 if( fn.size() == 1 ) res << (anything)in;
                 else return lookupInternal( fn%1, in );
             }
@@ -1562,7 +1567,7 @@ everything Sengine::request( const nameuc& name, Len len, $scope sc ) {
 
     if( auto impl = ($implementation)sc; impl and name.size() == 1 ) {
     //// 在实现中
-        auto inst = lookupElement( impl, sname );
+        auto inst = lookupElement( impl, name[0].name );
         if( inst ) res << (anything)inst;
         if( res.size() == 0 ) {
             if( auto org = requestThisClass(impl); !org ) return {};
@@ -1575,13 +1580,13 @@ everything Sengine::request( const nameuc& name, Len len, $scope sc ) {
             else return lookupInternal( name%1, mdef );
         } else {
             if( name.size() == 1 ) {
-                for( auto meta : mdef->metadefs + mdef->extmeta ) if( sname == (string)meta->name ) res << (anything)meta;
+                for( auto meta : mdef->metadefs + mdef->extmeta ) if( sname == meta->name.sym() ) res << (anything)meta;
             }
-            for( auto idef : mdef->internal + mdef->external ) if( (string)idef->name == sname ) {
+            for( auto idef : mdef->internal + mdef->external ) if( idef->name.sym() == sname ) {
                 if( name.size() == 1 ) res << (anything)idef;
                 else return lookupInternal( name%1, idef );
             }
-            for( auto ddef : mdef->desc->deps ) if( (string)ddef->literal() == sname ) {
+            for( auto ddef : mdef->desc->deps ) if( ddef->literal().sym() == sname ) {
                 if( name.size() == 1 ) res << (anything)mrepo[ddef->dest];
                 else return lookupInternal( name%1, mrepo[ddef->dest] );
             }
@@ -1594,16 +1599,16 @@ everything Sengine::request( const nameuc& name, Len len, $scope sc ) {
      */
         if( name.size() == 1 ) {
             if( len == ThisClass or len == SuperClass ) {
-                for( auto idef : cdef->instdefs + cdef->metadefs ) if( (string)idef->name == sname ) res << (anything)idef;
+                for( auto idef : cdef->instdefs + cdef->metadefs ) if( idef->name.sym() == sname ) res << (anything)idef;
                 for( auto idef : cdef->instdefs ) 
                     if( auto odef = ($OperatorDef)idef; odef
                         and odef->name.is(VN::OPL_MEMBER)
-                        and (string)odef->subtitle == sname ) res << (anything)idef;
+                        and odef->subtitle.sym() == sname ) res << (anything)idef;
                 for( const auto& super : cdef->supers ) if( auto sdef = requestClass(super,NormalClass); sdef ) 
                     res += request(name,SuperClass,sdef);
             }
             if( res.size() == 0 and len != SuperClass ) for( auto ndef : cdef->internal ) 
-                if( (string)ndef->name == sname ) res << (anything)ndef;
+                if( ndef->name.sym() == sname ) res << (anything)ndef;
         }
         if( len != SuperClass and res.size() == 0 ) { /** 对于普通类和当前类,若尚且查无所获,查询内部定义 */
                 res = lookupInternal(name, sc);
@@ -1654,9 +1659,9 @@ $definition Sengine::requestPrototype( $implementation impl ) {
         
         auto scope = requestThisClass(($implementation)met);
         if( !scope ) return nullptr;
-        auto sname = (string)met->name;
+        auto sname = met->name.sym();
 
-        for( auto def : scope->instdefs + scope->metadefs ) if( auto mdef = ($MethodDef)def; mdef and (string)mdef->name == sname ) {
+        for( auto def : scope->instdefs + scope->metadefs ) if( auto mdef = ($MethodDef)def; mdef and mdef->name.sym() == sname ) {
             if( mdef->size() != met->size() ) continue;
             if( (bool)mdef->constraint xor (bool)met->constraint ) continue;
             auto arg = met->begin();
@@ -2031,7 +2036,7 @@ bool Sengine::registerElement( $ConstructImpl ctis, $imm inst ) {
     if( mstackS.size() < 1 ) return false;
     auto& scope = mstackS[0];
 
-    for( auto& [is,in] : scope.elements ) if( (string)ctis->name == (string)is->name ) {
+    for( auto& [is,in] : scope.elements ) if( ctis->name.sym() == is->name.sym() ) {
         auto path = scope.title->getDocPath();
         mlogrepo(path)(Lengine::E2001,ctis->name,path,is->name);
         return false;
@@ -2062,7 +2067,7 @@ $imm Sengine::lookupElement( const token& name, $implementation sc ) {
         if( sec.title == sc ) {begin = true;}
         if( !begin ) continue;
         for( auto& [nm,inst] : sec.elements )
-            if( (string)nm->name == (string)name ) return inst;
+            if( nm->name.sym() == name.sym() ) return inst;
     }
     return nullptr;
 }
@@ -2079,17 +2084,13 @@ $ConstructImpl Sengine::lookupElement( $implementation sc, const token& name ) {
         if( sec.title == sc ) {begin = true;}
         if( !begin ) continue;
         for( auto& [nm,inst] : sec.elements )
-            if( (string)nm->name == (string)name ) return nm;
+            if( nm->name.sym() == name.sym() ) return nm;
     }
     return nullptr;
 }
 
-Sengine::Sengine() {
+Sengine::Sengine( Pengine* pengine ):mpengine(pengine) {
     using namespace sys;
-    TargetOptions opt;
-    std::string Error;
-    auto CPU = "generic";
-    auto Features = "";
 
     LLVMInitializeX86TargetInfo();
     LLVMInitializeX86Target();
@@ -2098,25 +2099,35 @@ Sengine::Sengine() {
     LLVMInitializeX86AsmPrinter();
 
     mttraiple = getDefaultTargetTriple();
-    auto target = TargetRegistry::lookupTarget(mttraiple, Error);
-    auto RM = Optional<Reloc::Model>();
-    mtmachine = target->createTargetMachine( mttraiple, CPU, Features, opt, RM);
+    mtmachine.reset(Bengine::createTargetMachine(mttraiple));
 }
 
 int Sengine::loadModuleDefinition( $modesc mod ) {
 
-    if( mrepo.count(mod) ) return 1;
+    if( mrepo.count(mod) ) return mrepo[mod]->es ? 2 : 1;
+    mod->deps.clear();
+    for( auto syn : mod->syntrees ) {
+        mod->deps += syn->signature->deps;
+        for( auto d : syn->signature->deps ) {
+            d->self = mod;
+            mod->manager->closeUpDependency(d);
+        }
+    }
+    return loadModuleDefinition(mod,mod->syntrees);
+}
+
+int Sengine::loadModuleDefinition( $modesc mod, const chainz<$ModuleGranule>& trees ) {
+
+    if( mrepo.count(mod) ) return mrepo[mod]->es ? 2 : 1;
     auto err = false;
     auto& root = mrepo[mod] = new module;
     root->desc = mod;
     root->name = mod->name;
     $ClassDef tpclass = nullptr;
-    mod->deps.clear();
 
-    for( auto syn : mod->syntrees ) {
+    for( auto syn : trees ) {
 
         syn->setScope(root);
-        mod->deps += syn->signature->deps;
 
         if( syn->signature->entry ) {
             if( root->es ) {
@@ -2127,11 +2138,6 @@ int Sengine::loadModuleDefinition( $modesc mod ) {
             }
         }
 
-        for( auto d : syn->signature->deps ) {
-            d->self = mod;
-            mod->manager->closeUpDependency(d);
-        }
-        
         for( auto& d : syn->defs ) {
             if( auto trans = ($ClassDef)d; trans and (string)d->name == mod->name ) {
                 if( tpclass ) {
@@ -2171,15 +2177,60 @@ int Sengine::loadModuleDefinition( $modesc mod ) {
     else return 1;
 }
 
+bool Sengine::replicate( const std::map<$modesc,chainz<$ModuleGranule>>& trees ) {
+    for( auto& [desc,copies] : trees ) if( !loadModuleDefinition(desc,copies) ) return false;
+    return performDefinitionSemanticValidation();
+}
+
+bool Sengine::hasModuleDefinition( $modesc mod ) {
+    return mrepo.count(mod) > 0;
+}
+
+void Sengine::unloadModuleDefinition( $modesc mod ) {
+    if( mrepo.count(mod) == 0 ) return;
+    mrepo.erase(mod);
+    mtrepo.erase(mod);
+
+    /**
+     * 类的结构体类型以"class.模块名"开头,它们被保留在命名类型表中,重新装载时通过setBody复用
+     * 若重新创建,llvm上下文会为重名的结构体追加后缀,上下文也会随装载次数不断增长
+     * 函数类型在每次定义语义检查时都会被覆盖 */
+    auto prefix = "class." + mod->name;
+    for( auto it = mnamedT.begin(); it != mnamedT.end(); ) {
+        auto& key = it->first;
+        if( !it->second->isStructTy() and !key.compare(0,prefix.size(),prefix) and (key.size() == prefix.size() or key[prefix.size()] == '.') ) it = mnamedT.erase(it);
+        else it++;
+    }
+    mmethodP.clear();
+    moperatorP.clear();
+    mcurmod = nullptr;
+
+    /** 描述符表重建时会替换依赖表,所以依据装载时闭合的,语法树中的依赖描述符寻找依赖此模块的模块 */
+    auto depends = [&]( $modesc desc ) {
+        for( auto syn : desc->syntrees ) for( auto& dep : syn->signature->deps ) 
+            if( dep->dest == mod ) return true;
+        return false;
+    };
+    vector<$modesc> dependents;
+    for( auto& [desc,m] : mrepo ) if( depends(desc) ) dependents.push_back(desc);
+    for( auto& desc : dependents ) unloadModuleDefinition(desc);
+}
+
 bool Sengine::performDefinitionSemanticValidation() {
 
     bool fine = true;
+    vector<$modesc> failed;
 
-    for( auto& [desc,mod] : mrepo ) {
+    for( auto& [desc,mod] : mrepo ) if( mtrepo.count(desc) == 0 ) {
+        auto measure = Pengine::scope(mpengine,"definition-sema",desc->name);
         mcurmod = mtrepo[desc] = std::make_shared<Module>(desc->name,mctx);
-        fine = performDefinitionSemanticValidation(desc) and fine;
+        if( !performDefinitionSemanticValidation(desc) ) failed.push_back(desc);
     }
 
+    for( auto& desc : failed ) {
+        unloadModuleDefinition(desc);
+        fine = false;
+    }
     return fine;
 }
 
@@ -2251,25 +2302,17 @@ Sengine::ModuleTrnsUnit Sengine::performImplementationSemanticValidation( $modes
     return mcurmod;
 }
 
-bool Sengine::triggerBackendTranslation( ModuleTrnsUnit unit, Dengine::vfdm fd, Dengine& dengine ) {
-    auto lfd = fd, wfd = fd, efd = fd;
-    wfd.name += ".w";
+bool Sengine::verifyTranslationUnit( ModuleTrnsUnit unit, Dengine::vfdm fd, Dengine& dengine ) {
+    auto lfd = fd, efd = fd;
     lfd.name += ".log";
     efd.name += ".ll";
     raw_fd_ostream ldest = raw_fd_ostream(dengine.getOfd(lfd),true);
-    raw_fd_ostream dest = raw_fd_ostream(dengine.getOfd(fd),true);
-    raw_fd_ostream wdest = raw_fd_ostream(dengine.getOfd(wfd),true);
-    legacy::PassManager pass;
+    raw_fd_ostream edest = raw_fd_ostream(dengine.getOfd(efd),true);
+    auto measure = Pengine::scope(mpengine,"verify",unit->getModuleIdentifier());
 
     unit->setTargetTriple(mttraiple);
     unit->setDataLayout(mtmachine->createDataLayout());
-    auto efdi = dengine.getOfd(efd);
-    auto se = dup(2);
-    dup2(efdi,2);
-    unit->dump();
-    dup2(se,2);
-    close(efdi);
-    mtmachine->addPassesToEmitFile(pass,dest,&wdest,TargetMachine::CGFT_ObjectFile);
+    unit->print(edest,nullptr);
     for( auto& fun : unit->getFunctionList() ) {
         string title = "\n--------------------- in function : ";
         title += fun.getName();
@@ -2278,16 +2321,23 @@ bool Sengine::triggerBackendTranslation( ModuleTrnsUnit unit, Dengine::vfdm fd,
         if( verifyFunction(fun,&ldest) ) return false;
     }
     if( verifyModule(*unit,&ldest) ) return false;
-    pass.run(*unit);
-    dest.flush();
     return true;
+}
 
+bool Sengine::triggerBackendTranslation( ModuleTrnsUnit unit, Dengine::vfdm fd, Dengine& dengine, string* image ) {
+    if( !verifyTranslationUnit(unit,fd,dengine) ) return false;
+    auto measure = Pengine::scope(mpengine,"emit",unit->getModuleIdentifier());
+    return Bengine::translate(*unit,*mtmachine,fd,dengine,image,mpengine);
 }
 
 Lengine::logr Sengine::getLog() {
     return mlogrepo;
 }
 
+void Sengine::clearLog() {
+    mlogrepo.clear();
+}
+
 }
 
 #endif
\ No newline at end of file
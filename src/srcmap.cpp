@@ -0,0 +1,125 @@
+#ifndef __srcmap_cpp__
+#define __srcmap_cpp__
+
+#include "srcmap.hpp"
+#include <unordered_map>
+#include <shared_mutex>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace alioth {
+
+/**
+ * @struct region : 区域
+ * @desc :
+ *  区域保存一个文档的文本和行表,行表记录每一行起始字节的偏移
+ *  区域占据[base,base+cap)之间的位置,文本不能超过容量
+ */
+struct region {
+    uint32_t base;
+    uint32_t cap;
+    std::string text;
+    std::vector<uint32_t> lines;
+};
+
+/**
+ * @struct atlas : 区域表
+ * @desc :
+ *  区域按起点排序,查找位置时只需二分
+ *  区域从位置1开始依次排布,被回收的区域留下的空隙供之后的区域使用
+ */
+struct atlas {
+    std::map<uint32_t,region> regions;
+    std::unordered_map<std::string,uint32_t> paths;
+    std::shared_mutex mutex;
+
+    /**
+     * @method allocate : 分配区域
+     * @desc :
+     *  寻找第一个足以容纳cap个位置的空隙
+     * @return uint32_t : 区域起点,位置空间耗尽时返回0
+     */
+    uint32_t allocate( uint64_t cap ) {
+        uint64_t at = 1;
+        for( auto& [base,r] : regions ) {
+            if( base - at >= cap ) break;
+            at = (uint64_t)base + r.cap;
+        }
+        if( at + cap > UINT32_MAX ) return 0;
+        return at;
+    }
+
+    const region* find( uint32_t loc )const {
+        auto i = regions.upper_bound(loc);
+        if( i == regions.begin() ) return nullptr;
+        i--;
+        if( loc - i->first > i->second.text.size() ) return nullptr;
+        return &i->second;
+    }
+};
+
+static atlas& table() {
+    static atlas t;
+    return t;
+}
+
+uint32_t srcmap::enter( const std::string& path, std::string_view text ) {
+    auto& t = table();
+    std::unique_lock<std::shared_mutex> lock(t.mutex);
+
+    region* r = nullptr;
+    if( auto i = t.paths.find(path); i != t.paths.end() ) {
+        r = &t.regions[i->second];
+        if( r->cap <= text.size() ) {
+            t.regions.erase(i->second);
+            t.paths.erase(i);
+            r = nullptr;
+        }
+    }
+
+    if( !r ) {
+        /** 为文本预留一半的余量,使常见的修改不必迁移区域 */
+        uint64_t cap = std::max<uint64_t>(text.size() + text.size()/2 + 1,4096);
+        auto base = t.allocate(cap);
+        if( !base ) return 0;
+        r = &t.regions[base];
+        r->base = base;
+        r->cap = cap;
+        t.paths[path] = base;
+    }
+
+    r->text.assign(text.data(),text.size());
+    r->lines.clear();
+    r->lines.push_back(0);
+    for( auto p = text.data(), e = p + text.size(); (p = (const char*)memchr(p,'\n',e-p)); p++ )
+        r->lines.push_back(p + 1 - text.data());
+    return r->base;
+}
+
+bool srcmap::locate( uint32_t loc, int& line, int& column ) {
+    line = column = 0;
+    auto& t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mutex);
+    auto r = t.find(loc);
+    if( !r ) return false;
+    uint32_t off = loc - r->base;
+    auto l = std::upper_bound(r->lines.begin(),r->lines.end(),off);
+    line = l - r->lines.begin();
+    column = off - l[-1] + 1;
+    return true;
+}
+
+std::string srcmap::text( uint32_t b, uint32_t e ) {
+    auto& t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mutex);
+    auto r = t.find(b);
+    if( !r or e < b or e - r->base > r->text.size() ) return std::string();
+    return r->text.substr(b - r->base,e - b);
+}
+
+}
+
+#endif
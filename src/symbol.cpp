@@ -0,0 +1,94 @@
+#ifndef __symbol_cpp__
+#define __symbol_cpp__
+
+#include "symbol.hpp"
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace alioth {
+
+/**
+ * @struct interner : 驻留表
+ * @desc :
+ *  被驻留的文本按编号存放在分块的表中,块一旦分配就不再移动,所以读取文本不需要加锁
+ *  散列表以文本的视图为键,视图引用的正是块中的文本
+ *  查找时持有共享锁,加入新文本时持有独占锁
+ *  驻留表最多容纳chunk*chunk个文本,耗尽后不再加入新文本
+ */
+struct interner {
+    static constexpr uint32_t width = 12;
+    static constexpr uint32_t chunk = 1 << width;
+
+    std::atomic<std::string*> chunks[chunk];
+    std::unordered_map<std::string_view,uint32_t> index;
+    std::shared_mutex mutex;
+    std::atomic<bool> full;
+    uint32_t count;
+
+    interner():chunks{},full(false),count(0) {
+        add("");
+    }
+
+    ~interner() {
+        for( auto& c : chunks ) delete[] c.load();
+    }
+
+    uint32_t add( std::string_view text ) {
+        auto id = count;
+        if( (id >> width) >= chunk ) {
+            full = true;
+            return 0;
+        }
+        auto& c = chunks[id >> width];
+        if( !c.load(std::memory_order_relaxed) ) c.store(new std::string[chunk],std::memory_order_release);
+        auto& slot = c.load(std::memory_order_relaxed)[id & (chunk-1)];
+        slot.assign(text.data(),text.size());
+        index.emplace(std::string_view(slot),id);
+        count += 1;
+        return id;
+    }
+};
+
+static interner& table() {
+    static interner t;
+    return t;
+}
+
+symbol::symbol( std::string_view text ):mid(intern(text)) {
+
+}
+
+symbol::symbol( const std::string& text ):mid(intern(text)) {
+
+}
+
+symbol::symbol( const char* text ):mid(intern(text)) {
+
+}
+
+uint32_t symbol::intern( std::string_view text ) {
+    if( text.empty() ) return 0;
+    auto& t = table();
+    {
+        std::shared_lock<std::shared_mutex> lock(t.mutex);
+        if( auto i = t.index.find(text); i != t.index.end() ) return i->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(t.mutex);
+    if( auto i = t.index.find(text); i != t.index.end() ) return i->second;
+    return t.add(text);
+}
+
+bool symbol::exhausted() {
+    return table().full;
+}
+
+const std::string& symbol::text( uint32_t id ) {
+    return table().chunks[id >> interner::width].load(std::memory_order_acquire)[id & (interner::chunk-1)];
+}
+
+}
+
+#endif
@@ -7,7 +7,9 @@
 using namespace std;
 namespace alioth {
 
-token::token(VT v ):id(v),in(VN::TERMINAL),bl(0),bc(0),el(0),ec(0) {
+static_assert(sizeof(token) == 16, "token must fit in 16 bytes");
+
+token::token(VT v ):id(v),in(VN::TERMINAL),bo(0),eo(0) {
 
 }
 
@@ -22,6 +24,10 @@ token::operator std::string()const {
     return Xengine::written(*this);
 }
 
+symbol token::sym()const {
+    return Xengine::symbolize(*this);
+}
+
 token::operator bool()const {
     return !is(VT::R_ERR);
 }
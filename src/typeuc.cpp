@@ -7,10 +7,11 @@
 
 namespace alioth {
 
-typeuc::typeuc( TypeID _id ):id(_id) {}
-typeuc::typeuc( $typeuc s, bool constrainted ):id(constrainted?ConstraintedPointerType:UnconstraintedPointerType), sub(s) {}
-typeuc::typeuc( $ClassDef def ):id(CompositeType),sub(def){}
-typeuc::typeuc( const nameuc& nm ):id(NamedType),name(nm) {}
+typeuc::typeuc():thing(cthing::typeuc) {}
+typeuc::typeuc( TypeID _id ):thing(cthing::typeuc),id(_id) {}
+typeuc::typeuc( $typeuc s, bool constrainted ):thing(cthing::typeuc),id(constrainted?ConstraintedPointerType:UnconstraintedPointerType), sub(s) {}
+typeuc::typeuc( $ClassDef def ):thing(cthing::typeuc),id(CompositeType),sub(def){}
+typeuc::typeuc( const nameuc& nm ):thing(cthing::typeuc),id(NamedType),name(nm) {}
 
 $typeuc typeuc::GetUnknownType() { return new typeuc(UnknownType); }
 $typeuc typeuc::GetNamedType( const nameuc& nm ) { return new typeuc(nm); }
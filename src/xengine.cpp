@@ -2,46 +2,533 @@
 #define __xengine_cpp__
 
 #include "xengine.hpp"
+#include "srcmap.hpp"
+#include <iterator>
+#include <cstring>
+
+#if defined(__x86_64__) or defined(__i386__)
+#include <immintrin.h>
+#define __alioth_simd__
+#endif
 
 namespace alioth {
 
-Jsonz Xengine::__table = JNull;
+/**
+ * @struct lexeme : 词条
+ * @desc :
+ *  词条描述一个书写形式确定的词法符号
+ */
+struct lexeme {
+    const char* text;
+    VT          id;
+};
+
+/**
+ * @member keywords : 关键字词条
+ * @desc :
+ *  标识符形式的关键字由完美散列表识别,词法自动机将它们与其他标识符一同接受
+ *  'as!'包含符号,不会作为标识符出现,所以只存在于词法自动机中
+ */
+static constexpr lexeme keywords[] = {
+    {"module",VT::MODULE},{"entry",VT::ENTRY},
+    {"obj",VT::OBJ},{"ptr",VT::PTR},{"ref",VT::REF},{"rel",VT::REL},
+    {"method",VT::METHOD},{"class",VT::CLASS},{"enum",VT::ENUM},{"operator",VT::OPERATOR},
+    {"int8",VT::INT8},{"int16",VT::INT16},{"int32",VT::INT32},{"int64",VT::INT64},
+    {"uint8",VT::UINT8},{"uint16",VT::UINT16},{"uint32",VT::UINT32},{"uint64",VT::UINT64},
+    {"float32",VT::FLOAT32},{"float64",VT::FLOAT64},{"bool",VT::BOOL},{"void",VT::VOID},
+    {"null",VT::iNULL},{"true",VT::iTRUE},{"false",VT::iFALSE},{"this",VT::iTHIS},
+    {"const",VT::CONST},{"meta",VT::META},{"public",VT::PUBLIC},{"private",VT::PRIVATE},
+    {"assume",VT::ASSUME},{"otherwise",VT::OTHERWISE},{"if",VT::IF},{"else",VT::ELSE},
+    {"loop",VT::LOOP},{"break",VT::BREAK},{"continue",VT::CONTINUE},{"return",VT::RETURN},
+    {"switch",VT::SWITCH},{"case",VT::CASE},{"default",VT::DEFAULT},
+    {"new",VT::NEW},{"delete",VT::DELETE},
+    {"and",VT::AND},{"or",VT::OR},{"not",VT::NOT},{"xor",VT::XOR},
+    {"as",VT::AS},{"as!",VT::TREAT},{"do",VT::DO},
+};
+
+/**
+ * @member dormant : 保留关键字词条
+ * @desc :
+ *  asm以及调用约定关键字尚未启用,它们依然被识别为标识符,但拥有书写形式
+ */
+static constexpr lexeme dormant[] = {
+    {"asm",VT::ASM},{"cdecl",VT::CDECL},{"stdcall",VT::STDCALL},{"fastcall",VT::FASTCALL},{"thiscall",VT::THISCALL},
+};
+
+/**
+ * @member operators : 运算符与界符词条
+ * @desc :
+ *  每个词条的所有前缀也都是词条,所以自动机在任何位置停止都能得到确定的词法符号
+ */
+static constexpr lexeme operators[] = {
+    {"~",VT::BITREV},{"!",VT::FORCE},{"!=",VT::NE},{"!!",VT::EXCEPTION},
+    {"@",VT::AT},{"#",VT::WHERE},{"$",VT::CONV},{"?",VT::ASK},
+    {"%",VT::MOL},{"%=",VT::ASSIGN_MOL},{"^",VT::BITXOR},{"^=",VT::ASSIGN_bXOR},
+    {"&",VT::BITAND},{"&=",VT::ASSIGN_bAND},{"|",VT::BITOR},{"|=",VT::ASSIGN_bOR},
+    {"*",VT::MUL},{"*=",VT::ASSIGN_MUL},{"/",VT::DIV},{"/=",VT::ASSIGN_DIV},
+    {"+",VT::PLUS},{"++",VT::INCRESS},{"+=",VT::ASSIGN_PLUS},
+    {"-",VT::MINUS},{"--",VT::DECRESS},{"-=",VT::ASSIGN_MINUS},
+    {"=",VT::ASSIGN},{"==",VT::EQ},
+    {"<",VT::LT},{"<=",VT::LE},{"<<",VT::SHL},{"<<=",VT::ASSIGN_SHL},
+    {">",VT::GT},{">=",VT::GE},{">>",VT::SHR},{">>=",VT::ASSIGN_SHR},
+    {"(",VT::OPENA},{")",VT::CLOSEA},{"[",VT::OPENL},{"]",VT::CLOSEL},{"{",VT::OPENS},{"}",VT::CLOSES},
+    {";",VT::SEMI},{",",VT::COMMA},{":",VT::COLON},{"::",VT::SCOPE},
+    {".",VT::MEMBER},{"..",VT::RANGE},{"...",VT::ETC},
+};
+
+static constexpr bool isalphac( int c ) { return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z'); }
+static constexpr bool isdigitc( int c ) { return c >= '0' and c <= '9'; }
+static constexpr bool isxdigitc( int c ) { return isdigitc(c) or (c >= 'a' and c <= 'f') or (c >= 'A' and c <= 'F'); }
+static constexpr bool isspacec( int c ) { return c == ' ' or (c >= '\t' and c <= '\r'); }
+static constexpr bool islabelc( int c ) { return isalphac(c) or isdigitc(c) or c == '_'; }
+static constexpr bool islabelw( const char* s ) { for( ; *s; s++ ) if( !islabelc(*s) ) return false; return true; }
+static constexpr size_t length( const char* s ) { size_t n = 0; while( s[n] ) n++; return n; }
+
+/**
+ * @function hashword : 散列函数
+ * @desc :
+ *  以种子为初值的FNV-1a散列,种子在编译期选取,使得所有关键字的散列值互不冲突
+ */
+static constexpr unsigned hashword( const char* s, size_t n, unsigned seed ) {
+    unsigned h = seed ^ (unsigned)n;
+    for( size_t i = 0; i < n; i++ ) h = (h ^ (unsigned char)s[i]) * 16777619u;
+    return h ^ (h >> 15);
+}
+
+/**
+ * @struct perfect : 关键字完美散列表
+ * @desc :
+ *  完美散列表的每个关键字独占一个槽位,查找时只需计算一次散列并比较一次文本
+ * @param M : 槽位数量,必须是2的幂
+ */
+template<int M>
+struct perfect {
+    unsigned    seed;
+    lexeme      slot[M];
+};
+
+template<int M>
+static constexpr perfect<M> arrange() {
+    for( unsigned seed = 1;; seed++ ) {
+        perfect<M> p = {seed,{}};
+        bool fine = true;
+        for( auto& l : keywords ) {
+            if( !islabelw(l.text) ) continue;
+            auto& s = p.slot[hashword(l.text,length(l.text),seed) & (M-1)];
+            if( s.text ) {fine = false;break;}
+            s = l;
+        }
+        if( fine ) return p;
+    }
+}
+
+static constexpr auto reserved = arrange<256>();
+
+/**
+ * @struct glossary : 词汇表
+ * @desc :
+ *  以终结符为下标的书写形式表,用于从终结符还原关键字的书写形式
+ */
+struct glossary {
+    const char* text[(int)VT::DO+1];
+};
+
+static constexpr glossary generateGlossary() {
+    glossary g = {};
+    for( auto& l : keywords ) g.text[(int)l.id] = l.text;
+    for( auto& l : dormant ) g.text[(int)l.id] = l.text;
+    return g;
+}
+
+static constexpr auto vocabulary = generateGlossary();
+
+/**
+ * @struct lettering : 书写形式的符号表
+ * @desc :
+ *  以终结符为下标,记录关键字,保留关键字和运算符的书写形式被驻留后的符号
+ *  词法分析时,书写形式确定的词法记号直接使用表中的符号,不必再次驻留文本
+ */
+struct lettering {
+    symbol sym[(int)VT::DO+1];
+
+    lettering() {
+        for( auto& l : keywords ) sym[(int)l.id] = symbol(l.text);
+        for( auto& l : dormant ) sym[(int)l.id] = symbol(l.text);
+        for( auto& l : operators ) sym[(int)l.id] = symbol(l.text);
+    }
+};
+
+static const lettering& letters() {
+    static const lettering l;
+    return l;
+}
+
+/**
+ * @struct automaton : 词法自动机
+ * @desc :
+ *  词法自动机是一个确定有限自动机,由字符分类表和状态转移表构成
+ *  状态0表示转移失败,状态1是初始状态
+ *  自动机从初始状态出发,尽可能多地吸收字节,转移失败时,当前状态的接受符号即为词法符号
+ *  字节首先被映射到字符分类,行为相同的字节共享一个分类,以压缩状态转移表
+ *  输入结束被视为一个单独的分类
+ * @param S : 状态总数的上限
+ * @param C : 字符分类总数的上限
+ */
+template<int S, int C>
+struct automaton {
+    int             nstate;         //状态总数
+    int             nclass;         //字符分类总数,包含输入结束
+    int             eof;            //输入结束所对应的字符分类
+    unsigned char   cls[256];       //字符分类表
+    unsigned short  next[S][C];     //状态转移表
+    VT              accept[S];      //各状态的接受符号
+};
+
+/**
+ * @function significant : 判断字节是否需要独立的字符分类
+ * @desc :
+ *  出现在词条中的字节,数字,十六进制数字,以及引导或终止字面量和注释的字节,都需要独立的字符分类
+ *  其余字节按照是否为字母,是否为空白分组
+ */
+static constexpr bool significant( int c ) {
+    for( auto& l : keywords ) for( auto p = l.text; *p; p++ ) if( *p == c ) return true;
+    for( auto& l : operators ) for( auto p = l.text; *p; p++ ) if( *p == c ) return true;
+    if( isxdigitc(c) ) return true;
+    switch( c ) {
+        case '\0': case '\n': case '_': case '\'': case '"': case '\\':
+        case 'b': case 'o': case 'x': case 'e': return true;
+        default: return false;
+    }
+}
+
+/**
+ * @function generate : 生成词法自动机
+ * @desc :
+ *  此函数在编译期执行,由词条生成词法自动机
+ *  含有符号的关键字被组织为前缀树,前缀树的节点在遇到其他标识符字符时转移到标识符状态
+ *  运算符被组织为另一棵前缀树,注释,字面量和数字由独立的状态描述
+ */
+template<int S, int C>
+static constexpr automaton<S,C> generate() {
+    automaton<S,C> a = {};
+
+    /** 字符分类 */
+    int alpha = -1, space = -1, other = -1;
+    for( int c = 0; c < 256; c++ ) {
+        int* group = nullptr;
+        if( !significant(c) ) group = isalphac(c) ? &alpha : isspacec(c) ? &space : &other;
+        if( group and *group >= 0 ) {
+            a.cls[c] = *group;
+        } else {
+            a.cls[c] = a.nclass++;
+            if( group ) *group = a.cls[c];
+        }
+    }
+    a.eof = a.nclass++;
+
+    auto state = [&a]( VT acc ) { a.accept[a.nstate] = acc; return a.nstate++; };
+    auto on = [&a]( int s, int c, int t ) { a.next[s][a.cls[c]] = t; };
+    auto any = [&a]( int s, int t ) { for( int c = 0; c < 256; c++ ) a.next[s][a.cls[c]] = t; };
+    auto labels = [&a]( int s, int t ) { for( int c = 0; c < 256; c++ ) if( islabelc(c) ) a.next[s][a.cls[c]] = t; };
+    auto digits = [&a]( int s, int t ) { for( int c = '0'; c <= '9'; c++ ) a.next[s][a.cls[c]] = t; };
+    auto alphas = [&a]( int s, int t ) { for( int c = 0; c < 256; c++ ) if( isalphac(c) ) a.next[s][a.cls[c]] = t; };
+
+    state(VT::R_ERR);                       //转移失败
+    int start = state(VT::R_ERR);           //初始状态
+    int error = state(VT::R_ERR);           //吸收一个无法识别的字节
+    int label = state(VT::LABEL);
+
+    any(start,error);
+    labels(label,label);
+    for( int c = 0; c < 256; c++ ) if( isalphac(c) or c == '_' ) on(start,c,label);
+
+    /** 空白 */
+    int space_ = state(VT::SPACE);
+    for( int c = 0; c < 256; c++ ) if( isspacec(c) ) on(start,c,space_), on(space_,c,space_);
+
+    /** 含有符号的关键字,标识符形式的关键字由完美散列表识别 */
+    for( auto& l : keywords ) {
+        if( islabelw(l.text) ) continue;
+        int s = start;
+        for( auto p = l.text; *p; p++ ) {
+            int n = a.next[s][a.cls[(unsigned char)*p]];
+            if( n == 0 or n == label or n == error ) {
+                n = state(VT::LABEL);
+                if( islabelc(*p) ) labels(n,label);
+                on(s,*p,n);
+            }
+            s = n;
+        }
+        a.accept[s] = l.id;
+    }
+
+    /** 运算符与界符 */
+    for( auto& l : operators ) {
+        int s = start;
+        for( auto p = l.text; *p; p++ ) {
+            int n = a.next[s][a.cls[(unsigned char)*p]];
+            if( n == 0 or n == error ) on(s,*p,n = state(VT::R_ERR));
+            s = n;
+        }
+        a.accept[s] = l.id;
+    }
+
+    /** 注释,块注释在输入结束前未闭合则为错误 */
+    int div = a.next[start][a.cls['/']];
+    int line = state(VT::COMMENT);
+    int block = state(VT::R_ERR);
+    int star = state(VT::R_ERR);
+    int close = state(VT::COMMENT);
+    on(div,'/',line);
+    any(line,line);
+    on(line,'\n',0), on(line,'\0',0);
+    on(div,'*',block);
+    any(block,block);
+    on(block,'*',star), on(block,'\0',0);
+    any(star,block);
+    on(star,'*',star), on(star,'/',close);
+
+    /** 字面字符串与字面字符,在输入结束或遇到空字节前未闭合则为错误 */
+    for( auto [q,id] : {std::make_pair('"',VT::iSTRING),std::make_pair('\'',VT::iCHAR)} ) {
+        int body = state(VT::R_ERR);
+        int escape = state(VT::R_ERR);
+        int done = state(id);
+        on(start,q,body);
+        any(body,body);
+        on(body,'\0',0), on(body,'\\',escape), on(body,q,done);
+        any(escape,body);
+        on(escape,'\0',0);
+    }
+
+    /** 数字,整数中可以使用'作为分隔符,紧随数字的字母是错误 */
+    int zero = state(VT::iINTEGERn);
+    int dec = state(VT::iINTEGERn);
+    int hex = state(VT::iINTEGERh);
+    int oct = state(VT::iINTEGERo);
+    int bin = state(VT::iINTEGERb);
+    int point = state(VT::R_ERR);
+    int frac = state(VT::iFLOAT);
+    int exp = state(VT::R_ERR);
+    int expd = state(VT::iFLOAT);
+    on(start,'0',zero);
+    for( int c = '1'; c <= '9'; c++ ) on(start,c,dec);
+    for( int s : {zero,dec,hex,oct,bin} ) alphas(s,error), on(s,'\'',s == zero ? dec : s);
+    for( int s : {zero,dec} ) digits(s,dec), on(s,'.',point), on(s,'e',exp);
+    on(zero,'b',bin), on(zero,'o',oct), on(zero,'x',hex);
+    for( int c = 0; c < 256; c++ ) if( isxdigitc(c) ) on(hex,c,hex);
+    on(hex,'.',point);
+    for( int c = '0'; c <= '7'; c++ ) on(oct,c,oct);
+    on(bin,'0',bin), on(bin,'1',bin);
+    any(point,error);
+    digits(point,frac);
+    digits(frac,frac);
+    on(frac,'e',exp);
+    any(exp,error);
+    digits(exp,expd), on(exp,'+',expd), on(exp,'-',expd);
+    digits(expd,expd);
+
+    return a;
+}
+
+/**
+ * 先以足够大的上限生成一次自动机,获得确切的状态总数和字符分类总数,再生成紧凑的自动机
+ */
+static constexpr auto probe = generate<512,128>();
+static constexpr auto lexer = generate<probe.nstate,probe.nclass>();
+
+/**
+ * @member exponent : 指数状态
+ * @desc :
+ *  吸收了指数部分数字的状态,若数字中含有分隔符',则此状态不能接受浮点数
+ */
+static constexpr int exponent = lexer.next[lexer.next[lexer.next[1][lexer.cls['1']]][lexer.cls['e']]][lexer.cls['1']];
+static_assert( lexer.accept[exponent] == VT::iFLOAT, "lexer automaton malformed" );
+
+/**
+ * @struct stretches : 连续段状态
+ * @desc :
+ *  空白,标识符,注释体和字面量体中的字节不改变自动机的状态,自动机在这些状态中会连续吸收大量字节
+ *  进入这些状态后,由扫描内核一次性跳过整段字节,直到遇见可能使状态改变的字节
+ */
+enum stretch : unsigned char { sNone, sSpace, sLabel, sLine, sBlock, sString, sChar };
+
+struct stretches {
+    stretch kind[lexer.nstate];
+};
 
-void Xengine::begin( std::istream& is, bool li ) {
+static constexpr stretches markStretches() {
+    stretches r = {};
+    auto at = []( int s, char c ) { return lexer.next[s][lexer.cls[(unsigned char)c]]; };
+    int div = at(1,'/');
+    r.kind[at(1,' ')] = sSpace;
+    r.kind[at(1,'_')] = sLabel;
+    r.kind[at(div,'/')] = sLine;
+    r.kind[at(div,'*')] = sBlock;
+    r.kind[at(1,'"')] = sString;
+    r.kind[at(1,'\'')] = sChar;
+    return r;
+}
+
+static constexpr auto stretchmap = markStretches();
+
+/**
+ * @struct scanner : 扫描内核
+ * @desc :
+ *  扫描内核从p开始,返回[p,e)中第一个不属于当前连续段的字节的位置,若不存在,返回e
+ *  spaces : 跳过空白
+ *  labels : 跳过标识符字符
+ *  until : 查找a,b,c三者中任意一个字节
+ *  内核有标量,SSE2和AVX2三个版本,在启动时根据CPUID选择处理器支持的最快版本
+ */
+struct scanner {
+    const char* (*spaces)( const char* p, const char* e );
+    const char* (*labels)( const char* p, const char* e );
+    const char* (*until)( const char* p, const char* e, char a, char b, char c );
+};
+
+static const char* scalarSpaces( const char* p, const char* e ) {
+    while( p < e and isspacec((unsigned char)*p) ) p++;
+    return p;
+}
+
+static const char* scalarLabels( const char* p, const char* e ) {
+    while( p < e and islabelc((unsigned char)*p) ) p++;
+    return p;
+}
+
+static const char* scalarUntil( const char* p, const char* e, char a, char b, char c ) {
+    while( p < e and *p != a and *p != b and *p != c ) p++;
+    return p;
+}
+
+#ifdef __alioth_simd__
+
+/**
+ * SSE2只有有符号比较,ascii字节都是正数,非ascii字节都是负数,所以区间判断不会误判非ascii字节
+ */
+#define __range(x,lo,hi) _mm_and_si128(_mm_cmpgt_epi8(x,_mm_set1_epi8((lo)-1)),_mm_cmplt_epi8(x,_mm_set1_epi8((hi)+1)))
+#define __range256(x,lo,hi) _mm256_and_si256(_mm256_cmpgt_epi8(x,_mm256_set1_epi8((lo)-1)),_mm256_cmpgt_epi8(_mm256_set1_epi8((hi)+1),x))
+
+static const char* sse2Spaces( const char* p, const char* e ) {
+    for( ; e - p >= 16; p += 16 ) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8(' ')),__range(x,'\t','\r'));
+        if( unsigned r = ~_mm_movemask_epi8(m) & 0xFFFF; r ) return p + __builtin_ctz(r);
+    }
+    return scalarSpaces(p,e);
+}
+
+static const char* sse2Labels( const char* p, const char* e ) {
+    for( ; e - p >= 16; p += 16 ) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        __m128i l = _mm_or_si128(x,_mm_set1_epi8(0x20));
+        __m128i m = _mm_or_si128(_mm_or_si128(__range(l,'a','z'),__range(x,'0','9')),_mm_cmpeq_epi8(x,_mm_set1_epi8('_')));
+        if( unsigned r = ~_mm_movemask_epi8(m) & 0xFFFF; r ) return p + __builtin_ctz(r);
+    }
+    return scalarLabels(p,e);
+}
+
+static const char* sse2Until( const char* p, const char* e, char a, char b, char c ) {
+    __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+    for( ; e - p >= 16; p += 16 ) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x,va),_mm_cmpeq_epi8(x,vb)),_mm_cmpeq_epi8(x,vc));
+        if( unsigned r = _mm_movemask_epi8(m); r ) return p + __builtin_ctz(r);
+    }
+    return scalarUntil(p,e,a,b,c);
+}
+
+__attribute__((target("avx2")))
+static const char* avx2Spaces( const char* p, const char* e ) {
+    for( ; e - p >= 32; p += 32 ) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(x,_mm256_set1_epi8(' ')),__range256(x,'\t','\r'));
+        if( unsigned r = ~(unsigned)_mm256_movemask_epi8(m); r ) return p + __builtin_ctz(r);
+    }
+    return sse2Spaces(p,e);
+}
+
+__attribute__((target("avx2")))
+static const char* avx2Labels( const char* p, const char* e ) {
+    for( ; e - p >= 32; p += 32 ) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i l = _mm256_or_si256(x,_mm256_set1_epi8(0x20));
+        __m256i m = _mm256_or_si256(_mm256_or_si256(__range256(l,'a','z'),__range256(x,'0','9')),_mm256_cmpeq_epi8(x,_mm256_set1_epi8('_')));
+        if( unsigned r = ~(unsigned)_mm256_movemask_epi8(m); r ) return p + __builtin_ctz(r);
+    }
+    return sse2Labels(p,e);
+}
+
+__attribute__((target("avx2")))
+static const char* avx2Until( const char* p, const char* e, char a, char b, char c ) {
+    __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+    for( ; e - p >= 32; p += 32 ) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x,va),_mm256_cmpeq_epi8(x,vb)),_mm256_cmpeq_epi8(x,vc));
+        if( unsigned r = _mm256_movemask_epi8(m); r ) return p + __builtin_ctz(r);
+    }
+    return sse2Until(p,e,a,b,c);
+}
+
+#undef __range
+#undef __range256
+
+#endif
+
+static scanner chooseScanner() {
+#ifdef __alioth_simd__
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx2") ) return {avx2Spaces,avx2Labels,avx2Until};
+    if( __builtin_cpu_supports("sse2") ) return {sse2Spaces,sse2Labels,sse2Until};
+#endif
+    return {scalarSpaces,scalarLabels,scalarUntil};
+}
+
+static const scanner scan = chooseScanner();
+
+/**
+ * @function stride : 跳过连续段
+ * @desc :
+ *  根据自动机当前所处的连续段状态,使用扫描内核跳过不会改变状态的字节
+ *  跳过之后,自动机依然处于原状态,由状态转移表处理终止连续段的字节
+ */
+static inline const char* stride( stretch k, const char* p, const char* e ) {
+    switch( k ) {
+        case sSpace: return scan.spaces(p,e);
+        case sLabel: return scan.labels(p,e);
+        case sLine: return scan.until(p,e,'\n','\0','\n');
+        case sBlock: return scan.until(p,e,'*','\0','*');
+        case sString: return scan.until(p,e,'"','\\','\0');
+        case sChar: return scan.until(p,e,'\'','\\','\0');
+        default: return p;
+    }
+}
+
+void Xengine::begin( bool li, bool st, tokens* tr ) {
     state = 1;
-    stay = false;
     synst = 1;
     limit = li;
-    pis = &is;
+    strip = st;
+    trivia = tr;
     T = token(VT::R_BEG);
+    T.bo = T.eo = base;
     ret.clear();
-    ret << std::move(T);
-    T.bl = begl = 1;
-    T.bc = begc = 1;
-    pre = pis->peek();
-}
-
-void Xengine::goon() {
-    if( stay ) {stay = false;return;}
-    if( pre == '\n' ) begl += begc = 1;
-    else begc += 1;
-    T.tx += pis->get();
-    pre = pis->peek();
-};
-
-void Xengine::check(VT t,bool s ) {
-    if( s ) goon();
-    
-    T.id = t;
-    T.el = begl;
-    T.ec = begc;
-    ret << std::move(T);
+    ret << T;
+}
 
-    T.tx.clear();
-    T.bl = begl;
-    T.bc = begc;
-    state = ((pre==EOF)?0:1);
-    stay = true;
+void Xengine::check( VT t, const char* b, const char* e ) {
+    bool keep = !strip or (t != VT::SPACE and t != VT::COMMENT);
+    if( keep or (trivia and t == VT::COMMENT) ) {
+        T.id = t;
+        T.bo = base + (b - org);
+        T.eo = base + (e - org);
+        if( auto f = letters().sym[(int)t]; !f.empty() ) T.tx = f;
+        else if( t == VT::LABEL ) T.tx.assign(b,e);
+        else T.tx.clear();
+        if( t == VT::LABEL and T.tx.empty() ) T.id = VT::R_ERR;
+        if( keep ) ret << T;
+        else *trivia << T;
+    }
 
     /*微型语法分析器*/
     if( limit ) switch(t) {
@@ -91,519 +578,204 @@ void Xengine::check(VT t,bool s ) {
     }
 };
 
-void Xengine::test(VT v, int o ){
-    T.id = v;
-    fixed = __table[(int)v];
-    off = o+1;
-    state = 2;      //用于单词测试的状态
-};
-
-void Xengine::prefix( const char* s, int o, int t ) {
-    fixed = s;
-    off = o+1;
-    target = t;
-    state = 5;      //用于前缀测试的状态
-};
+tokens Xengine::extractTokens( std::istream& is, bool limit, bool strip, tokens* trivia ) {
+    std::string src((std::istreambuf_iterator<char>(is)),std::istreambuf_iterator<char>());
+    return extractTokens(src.data(),src.data()+src.size(),limit,strip,trivia);
+}
 
-void Xengine::assign(VT h, VT m) {
-    T.id = m;
-    hit = h;
-    state = 6;      //用于赋值测试的状态
-};
+void Xengine::step( const char*& p, const char* e ) {
+    const char* b = p;
+    int s = 1;
+    while( auto n = lexer.next[s][p < e ? lexer.cls[(unsigned char)*p] : lexer.eof] ) {
+        s = n;
+        p += 1;
+        if( auto k = stretchmap.kind[s]; k ) p = stride(k,p,e);
+    }
+    VT t = lexer.accept[s];
+    if( t == VT::LABEL ) t = keyword(b,p-b);
+    if( s == exponent and memchr(b,'\'',p-b) ) t = VT::R_ERR;
+    check(t,b,p);
+}
 
-void Xengine::sequence( VT h ) {
-        T.id = h;
-        state = 7;
-}
-
-bool Xengine::islabel( int c ) {
-    return isalnum(c) or c == '_';
-}
-bool Xengine::islabelb( int c ) {
-    return isalpha(c) or c == '_';
-}
-
-tokens Xengine::extractTokens( std::istream& is, bool limit ) {
-
-    for( begin(is,limit); state > 0; goon() ) switch( state ) {
-        case 1:
-            if( pre == EOF ) state = 0;
-            else if( isspace(pre) ) state = 3;
-            else if( pre == 'a' ) state = 10;
-            else if( pre == 'b' ) state = 11;
-            else if( pre == 'c' ) state = 12;
-            else if( pre == 'd' ) state = 16;
-            else if( pre == 'e' ) state = 18;
-            else if( pre == 'f' ) state = 20;
-            else if( pre == 'i' ) state = 22;
-            else if( pre == 'l' ) state = 24;
-            else if( pre == 'm' ) state = 25;
-            else if( pre == 'n' ) state = 27;
-            else if( pre == 'o' ) state = 28;
-            else if( pre == 'p' ) state = 29;
-            else if( pre == 'r' ) state = 30;
-            else if( pre == 's' ) state = 32;
-            else if( pre == 't' ) state = 33;
-            else if( pre == 'u' ) state = 34;
-            else if( pre == 'v' ) state = 37;
-            else if( pre == 'x' ) state = 59;
-            else if( islabelb(pre) ) state = 4;
-            else if( pre == '~' ) check(VT::BITREV,true);
-            else if( pre == '!' ) state = 57;//assign(VT::NE,VT::FORCE);
-            else if( pre == '@' ) check(VT::AT,true);
-            else if( pre == '#' ) check(VT::WHERE,true);
-            else if( pre == '$' ) check(VT::CONV,true);
-            else if( pre == '%' ) assign(VT::ASSIGN_MOL,VT::MOL);
-            else if( pre == '^' ) assign(VT::ASSIGN_bXOR,VT::BITXOR);
-            else if( pre == '&' ) assign(VT::ASSIGN_bAND,VT::BITAND);
-            else if( pre == '*' ) assign(VT::ASSIGN_MUL,VT::MUL);
-            else if( pre == '(' ) check(VT::OPENA,true);
-            else if( pre == ')' ) check(VT::CLOSEA,true);
-            else if( pre == '-' ) state = 38;
-            else if( pre == '+' ) state = 39;
-            else if( pre == '=' ) assign(VT::EQ,VT::ASSIGN);
-            else if( pre == '[' ) check(VT::OPENL,true);
-            else if( pre == ']' ) check(VT::CLOSEL,true);
-            else if( pre == '{' ) check(VT::OPENS,true);
-            else if( pre == '}' ) check(VT::CLOSES,true);
-            else if( pre == '|' ) assign(VT::ASSIGN_bOR,VT::BITOR);
-            else if( pre == ';' ) check(VT::SEMI,true);
-            else if( pre == ':' ) state = 40;
-            else if( pre == ',' ) check(VT::COMMA,true);
-            else if( pre == '?' ) check(VT::ASK,true);
-            else if( pre == '<' ) state = 41;
-            else if( pre == '>' ) state = 42;
-            else if( pre == '.' ) state = 43;
-            else if( pre == '/' ) state = 45;
-            else if( pre == '"' ) sequence(VT::iSTRING);
-            else if( pre == '\'') sequence(VT::iCHAR);
-            else if( pre == '0' ) state = 9;
-            else if( pre >= '1' and pre <= '9' ) {T.id = VT::iINTEGERn; state = 50;}
-            else check(VT::R_ERR,true);
-            break;
-        case 2:
-            if( pre and pre == fixed[off] ) off += 1;
-            else if( islabel(pre) ) state = 4;
-            else if( off == (long long)fixed.size() ) check(T.id,false);
-            else check(VT::LABEL,false);
-            break;
-        case 3:
-            if( !isspace(pre) ) check(VT::SPACE,false); 
-            break;
-        case 4:
-            if( !islabel(pre) ) check(VT::LABEL,false);
-            break;
-        case 5:
-            if( pre and pre == fixed[off] ) off += 1;
-            else if( off == (long long)fixed.size() ) {state = target;stay = true;}
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 6:
-            if( pre == '=' ) check(hit,true);
-            else check(T.id,false);
-            break;
-        case 7:
-            if( T.id == VT::iSTRING and pre == '\"' ) check(T.id,true);
-            else if( T.id == VT::iCHAR and pre == '\'' ) check(T.id,true);
-            else if( pre == '\0' or pre == EOF ) check(VT::R_ERR,false);
-            else if( pre == '\\' ) state = 8;
-            break;
-        case 8:
-            if( pre == '\0' or pre == EOF ) check(VT::R_ERR,false);
-            else state = 7;
-            break;
-        case 9:
-            if( pre == 'b') {T.id = VT::iINTEGERb; state = 52;}
-            else if( pre == 'o' ) {T.id = VT::iINTEGERo; state = 51;}
-            else if( pre == 'x' ) {T.id = VT::iINTEGERh; state = 49;}
-            else {T.id = VT::iINTEGERn; state = 50;stay = true;}
-            break;
-        case 10:
-            if( pre == 's' ) state = 15;
-            else if( pre == 'n' ) test(VT::AND,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 11:
-            if( pre == 'r' ) test(VT::BREAK,1);
-            else if( pre == 'o' ) test(VT::BOOL,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 12:
-            if( pre == 'o' ) state = 13;
-            else if( pre == 'l' ) test(VT::CLASS,1);
-            else if( pre == 'a' ) test(VT::CASE,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 13:
-            if( pre == 'n' ) state = 14;
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 14:
-            if( pre == 's' ) test(VT::CONST,3);
-            else if( pre == 't' ) test(VT::CONTINUE,3);
-            else check(VT::LABEL,false);
-            break;
-        case 15:
-            if( pre == 's' ) test(VT::ASSUME,2);
-            else if( pre == '!' ) check(VT::TREAT,true);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::AS,false);
-            break;
-        case 16:
-            if( pre == 'e' ) state = 17;
-            else if( pre == 'o' ) test(VT::DO, 1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 17:
-            if( pre == 'l' ) test(VT::DELETE,2);
-            else if( pre == 'f' ) test(VT::DEFAULT,2);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 18:
-            if( pre == 'n' ) state = 19;
-            else if( pre == 'l' ) test(VT::ELSE,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 19:
-            if( pre == 'u' ) test(VT::ENUM,2);
-            else if( pre == 't' ) test(VT::ENTRY,2);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 20:
-            if( pre == 'a' ) test(VT::iFALSE,1);
-            else if( pre == 'l' ) prefix("float",1,21);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 21:
-            if( pre == '3' ) test(VT::FLOAT32,5);
-            else if( pre == '6' ) test(VT::FLOAT64,5);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 22:
-            if( pre == 'f' ) test(VT::IF,1);
-            else if( pre == 'n' ) prefix("int",1,23);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 23:
-            if( pre == '8' ) test(VT::INT8,3);
-            else if( pre == '1' ) test(VT::INT16,3);
-            else if( pre == '3' ) test(VT::INT32,3);
-            else if( pre == '6' ) test(VT::INT64,3);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 24:
-            if( pre == 'o' ) test(VT::LOOP,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 25:
-            if( pre == 'e' ) prefix("met",1,58);
-            else if( pre == 'o' ) prefix("mod",1,26);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 26:
-            if( pre == 'u' ) test(VT::MODULE,3);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 27:
-            if( pre == 'e' ) test(VT::NEW,1);
-            else if( pre == 'o' ) test(VT::NOT,1);
-            else if( pre == 'u' ) test(VT::iNULL,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 28:
-            if( pre == 'b' ) state = 36;
-            else if( pre == 'r' ) test(VT::OR,1);
-            else if( pre == 't' ) test(VT::OTHERWISE,1);
-            else if( pre == 'p' ) test(VT::OPERATOR,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 29:
-            if( pre == 'r' ) test(VT::PRIVATE,1);
-            else if( pre == 't' ) test(VT::PTR,1);
-            else if( pre == 'u' ) test(VT::PUBLIC,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 30:
-            if( pre == 'e' ) state = 31;
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 31:
-            if( pre == 'f' ) test(VT::REF,2);
-            else if( pre == 'l' ) test(VT::REL,2);
-            else if( pre == 't' ) test(VT::RETURN,2);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 32:
-            if( pre == 'w' ) test(VT::SWITCH,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 33:
-            if( pre == 'h' ) test(VT::iTHIS,1);
-            else if( pre == 'r' ) test(VT::iTRUE,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 34:
-            if( pre == 'i' ) prefix("uint",1,35);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 35:
-            if( pre == '8' ) test(VT::UINT8,4);
-            else if( pre == '1' ) test(VT::UINT16,4);
-            else if( pre == '3' ) test(VT::UINT32,4);
-            else if( pre == '6' ) test(VT::UINT64,4);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 36:
-            if( pre == 'j' ) test(VT::OBJ,2);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 37:
-            if( pre == 'o' ) test(VT::VOID,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 38:
-            if( pre == '-' ) check(VT::DECRESS,true);
-            else if( pre == '=' ) check(VT::ASSIGN_MINUS,true);
-            else check(VT::MINUS,false);
-            break;
-        case 39:
-            if( pre == '+' ) check(VT::INCRESS,true);
-            else if( pre == '=' ) check(VT::ASSIGN_PLUS,true);
-            else check(VT::PLUS,false);
-            break;
-        case 40:
-            if( pre == ':' ) check(VT::SCOPE,true);
-            else check(VT::COLON,false);
-            break;
-        case 41:
-            if( pre == '<' ) assign(VT::ASSIGN_SHL,VT::SHL);
-            else if( pre == '=' ) check(VT::LE,true);
-            else check(VT::LT,false);
-            break;
-        case 42:
-            if( pre == '>' ) assign(VT::ASSIGN_SHR,VT::SHR);
-            else if( pre == '=' ) check(VT::GE,true);
-            else check(VT::GT,false);
-            break;
-        case 43:
-            if( pre == '.' ) state = 44;
-            else check(VT::MEMBER,false);
-            break;
-        case 44:
-            if( pre == '.' ) check(VT::ETC,true);
-            else check(VT::RANGE,false);
-            break;
-        case 45:
-            if( pre == '/' ) state = 46;
-            else if( pre == '*' ) state = 47;
-            else if( pre == '=' ) check(VT::ASSIGN_DIV,true);
-            else check(VT::DIV,false);
-            break;
-        case 46:
-            if( pre == '\n' or pre == EOF or pre == '\0' ) check(VT::COMMENT,false);
-            break;
-        case 47:
-            if( pre == '*' ) state = 48;
-            else if( pre == EOF or pre == '\0' ) check(VT::R_ERR,false);
-            break;
-        case 48:
-            if( pre == '/' ) check(VT::COMMENT,true);
-            else if( pre != '*' ) state = 47;
-            else if( pre == EOF or pre == '\0' ) check(VT::R_ERR,false);
-            break;
-        case 49:
-            if( (pre >= 'a' and pre <= 'f') or (pre >= 'A' and pre <= 'F') ) continue;
-            [[fallthrough]];
-        case 50:
-            if( pre == '8' or pre == '9' ) continue;
-            else if( pre == '.' ) {state = 53;break;}
-            else if( pre == 'e' ) {state = 55;break;}
-            [[fallthrough]];
-        case 51:
-            if( pre >= '2' and pre <= '7' ) continue;
-            [[fallthrough]];
-        case 52:
-            if( pre == '0' or pre == '1' or pre == '\'' ) continue;
-            else if( isalpha(pre) ) check(VT::R_ERR,true);
-            else check(T.id,false);
-            break;
-        case 53:
-            if( pre >= '0' and pre <= '9' ) state = 54;
-            else check(VT::R_ERR,true);
-            break;
-        case 54:
-            if( pre >= '0' and pre <= '9' ) continue;
-            else if( pre == 'e' ) state = 55;
-            else if( T.tx.find('\'') == std::string::npos ) check(VT::iFLOAT,false);
-            else check(VT::iFLOAT,false);
-            break;
-        case 55:
-            if( pre == '-' or pre == '+' ) state = 56;
-            else if( pre >= '0' and pre <= '9' ) state = 56;
-            else check(VT::R_ERR,true);
-            break;
-        case 56:
-            if( pre >= '0' and pre <= '9' ) continue;
-            else if( T.tx.find('\'') == std::string::npos ) check(VT::iFLOAT,false);
-            else check(VT::R_ERR,false);
-            break;
-        case 57:
-            if( pre == '=' ) check(VT::NE,true);
-            else if( pre == '!' ) check(VT::EXCEPTION,true);
-            else check(VT::FORCE,false);
-            break;
-        case 58:
-            if( pre == 'a' ) test(VT::META,3);
-            else if( pre == 'h' ) test(VT::METHOD,3);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
-        case 59:
-            if( pre == 'o' ) test(VT::XOR,1);
-            else if( islabel(pre) ) state = 4;
-            else check(VT::LABEL,false);
-            break;
+tokens Xengine::extractTokens( const char* p, const char* e, bool limit, bool strip, tokens* trivia ) {
+    base = srcmap::enter(path,std::string_view(p,e-p));
+    org = p;
+    begin(limit,strip,trivia);
+    if( !base ) {
+        ret << token(VT::R_END);
+        return std::move(ret);
     }
 
+    while( p < e and state > 0 ) step(p,e);
+
     if( state < 0 ) {
         ret[-1].id = VT::R_END;
     } else {
         ret << token(VT::R_END);
-        ret[-1].bl = ret[-1].el = begl;
-        ret[-1].bc = ret[-1].ec = begc;
+        ret[-1].bo = ret[-1].eo = base + (p - org);
     }
     return std::move(ret);
 }
 
-void Xengine::init() {
-    if( __table.is(JNull) ) {
-        __table = Jsonz(JArray);
-
-        __table[(int)VT::MODULE] = "module";
-        __table[(int)VT::ENTRY] = "entry";
-        __table[(int)VT::OBJ] = "obj";
-        __table[(int)VT::PTR] = "ptr";
-        __table[(int)VT::REF] = "ref";
-        __table[(int)VT::REL] = "rel";
-        __table[(int)VT::METHOD] = "method";
-        __table[(int)VT::CLASS] = "class";
-        __table[(int)VT::ENUM] = "enum";
-        __table[(int)VT::OPERATOR] = "operator";
-        __table[(int)VT::ASM] = "asm";
-        __table[(int)VT::INT8] = "int8";
-        __table[(int)VT::INT16] = "int16";
-        __table[(int)VT::INT32] = "int32";
-        __table[(int)VT::INT64] = "int64";
-        __table[(int)VT::UINT8] = "uint8";
-        __table[(int)VT::UINT16] = "uint16";
-        __table[(int)VT::UINT32] = "uint32";
-        __table[(int)VT::UINT64] = "uint64";
-        __table[(int)VT::FLOAT32] = "float32";
-        __table[(int)VT::FLOAT64] = "float64";
-        __table[(int)VT::BOOL] = "bool";
-        __table[(int)VT::iNULL] = "null";
-        __table[(int)VT::VOID] = "void";
-        __table[(int)VT::iTRUE] = "true";
-        __table[(int)VT::iFALSE] = "false";
-        __table[(int)VT::iTHIS] = "this";
-        __table[(int)VT::CONST] = "const";
-        __table[(int)VT::META] = "meta";
-        __table[(int)VT::PUBLIC] = "public";
-        __table[(int)VT::PRIVATE] = "private";
-        __table[(int)VT::CDECL] = "cdecl";
-        __table[(int)VT::STDCALL] = "stdcall";
-        __table[(int)VT::FASTCALL] = "fastcall";
-        __table[(int)VT::THISCALL] = "thiscall";
-        __table[(int)VT::ASSUME] = "assume";
-        __table[(int)VT::OTHERWISE] = "otherwise";
-        __table[(int)VT::IF] = "if";
-        __table[(int)VT::ELSE] = "else";
-        __table[(int)VT::LOOP] = "loop";
-        __table[(int)VT::BREAK] = "break";
-        __table[(int)VT::CONTINUE] = "continue";
-        __table[(int)VT::RETURN] = "return";
-        __table[(int)VT::SWITCH] = "switch";
-        __table[(int)VT::CASE] = "case";
-        __table[(int)VT::DEFAULT] = "default";
-        __table[(int)VT::NEW] = "new";
-        __table[(int)VT::DELETE] = "delete";
-        __table[(int)VT::AND] = "and";
-        __table[(int)VT::OR] = "or";
-        __table[(int)VT::NOT] = "not";
-        __table[(int)VT::AS] = "as";
-        __table[(int)VT::DO] = "do";
+int Xengine::edit::reach()const {
+    return b + text.size();
+}
+
+int Xengine::edit::delta()const {
+    return (int)text.size() - (e - b);
+}
+
+Xengine::edit Xengine::diff( std::string_view before, std::string_view after ) {
+    size_t head = 0, tail = 0;
+    size_t most = std::min(before.size(),after.size());
+    while( head < most and before[head] == after[head] ) head++;
+    while( tail < most - head and before[before.size()-tail-1] == after[after.size()-tail-1] ) tail++;
+
+    edit ed;
+    ed.b = head;
+    ed.e = before.size() - tail;
+    ed.text.assign(after.data()+head,after.size()-tail-head);
+    return ed;
+}
+
+tokens Xengine::relexSourceCode( const tokens& prev, const char* src, size_t size, edit& ed ) {
+    ed.s = -1;
+    if( ed.b < 0 or prev.size() < 2 or !prev[0].is(VT::R_BEG) or !prev[-1].is(VT::R_END) ) {
+        ed.b = -1;
+        return parseSourceCode(src,size,nullptr);
+    }
+
+    /** 新文本必须留在旧记号所在的区域中,区域迁移之后旧记号的位置全部失效 */
+    base = srcmap::enter(path,std::string_view(src,size));
+    if( !base or base != prev[0].bo ) {
+        ed.b = -1;
+        return parseSourceCode(src,size,nullptr);
+    }
+
+    int last = prev.size() - 1;
+    uint32_t from = base + ed.b, to = base + ed.e, reach = base + ed.reach();
+    auto origin = [&]( int i ) { return prev[i].bo + ed.delta(); };
+
+    /** 修改之前的完好记号为[1,k],修改之后的旧记号从j开始 */
+    int k = 0;
+    while( k + 1 < last and prev[k+1].eo < from ) k++;
+    int j = k + 1;
+    while( j < last and prev[j].bo < to ) j++;
+
+    org = src;
+    begin(false,true,nullptr);
+    ret.reserve(prev.size() + 64);
+    for( int i = 1; i <= k; i++ ) ret << prev[i];
+
+    /** 从最后一个完好记号之后开始重新分析 */
+    const char* p = src + (k > 0 ? prev[k].eo - base : 0);
+    const char* e = src + size;
+
+    /** 越过修改的终点后,寻找与旧记号起点重合的词法符号边界 */
+    bool synced = false;
+    while( !synced and p < e ) {
+        step(p,e);
+        uint32_t at = base + (p - org);
+        if( at < reach ) continue;
+        while( j < last and origin(j) < at ) j++;
+        synced = j < last and origin(j) == at;
     }
+
+    if( synced ) {
+        ed.s = p - org;
+        for( ; j <= last; j++ ) {
+            ret << prev[j];
+            ret[-1].bo += ed.delta();
+            ret[-1].eo += ed.delta();
+        }
+    } else {
+        ret << token(VT::R_END);
+        ret[-1].bo = ret[-1].eo = base + (p - org);
+    }
+    return std::move(ret);
 }
 
-Xengine::Xengine() {
-    init();
+Xengine::Xengine( const std::string& p ):path(p),base(0),org(nullptr) {
+
 }
 
 tokens Xengine::parseSourceCode( std::istream& is ) {
     return extractTokens(is,false);
 }
 
+tokens Xengine::parseSourceCode( std::istream& is, tokens* trivia ) {
+    return extractTokens(is,false,true,trivia);
+}
+
+tokens Xengine::parseSourceCode( const char* src, size_t size, tokens* trivia ) {
+    return extractTokens(src,src+size,false,true,trivia);
+}
+
 tokens Xengine::parseModuleSignature( std::istream& is ) {
     return extractTokens(is,true);
 }
 
+tokens Xengine::parseModuleSignature( const char* src, size_t size ) {
+    return extractTokens(src,src+size,true);
+}
+
 std::string Xengine::written( const token& t ) {
-    init();
-    auto& str = __table.at((int)t.id);
-    if( !null(&str) and str.is(JString) ) return str;
-    return t.tx;
+    if( !t.is(VN::TERMINAL) ) return t.tx.empty() ? phrase(t) : (std::string)t.tx;
+    if( auto s = spelling(t.id); s ) return s;
+    if( !t.tx.empty() ) return t.tx;
+    return srcmap::text(t.bo,t.eo);
 }
 
-bool Xengine::isLabel( const std::string& s ) {
-    if( s.empty() ) return false;
-    if( !islabelb(s[0]) ) return false;
-    for( auto& c : s )
-        if( !islabel(c) ) 
-            return false;
-    return true;
+symbol Xengine::symbolize( const token& t ) {
+    if( !t.is(VN::TERMINAL) ) return t.tx.empty() ? symbol(phrase(t)) : t.tx;
+    if( spelling(t.id) ) return letters().sym[(int)t.id];
+    if( !t.tx.empty() ) return t.tx;
+    return srcmap::text(t.bo,t.eo);
+}
+
+std::string Xengine::phrase( const token& t ) {
+    auto src = srcmap::text(t.bo,t.eo);
+    Xengine lexical;
+    lexical.base = 0;
+    lexical.org = src.data();
+    lexical.begin(false,true,nullptr);
+    for( const char* p = src.data(), *e = p + src.size(); p < e; ) lexical.step(p,e);
+
+    std::string ret;
+    for( auto& i : lexical.ret ) if( !i.is(VT::R_BEG) ) {
+        auto w = std::string_view(src).substr(i.bo,i.eo-i.bo);
+        if( !ret.empty() and !w.empty() and isalnum(ret.back()) and isalnum(w[0]) ) ret += ' ';
+        ret += w;
+    }
+    return ret;
+}
+
+VT Xengine::keyword( const char* s, size_t n ) {
+    auto& l = reserved.slot[hashword(s,n,reserved.seed) & 255];
+    if( l.text and !strncmp(l.text,s,n) and !l.text[n] ) return l.id;
+    return VT::LABEL;
+}
+
+const char* Xengine::spelling( VT v ) {
+    if( (int)v < 0 or (int)v > (int)VT::DO ) return nullptr;
+    return vocabulary.text[(int)v];
 }
 
 std::string Xengine::extractText( const token& t ) {
-    if( !t.is(VT::iSTRING,VT::iCHAR) ) return t.tx;
+    auto tx = written(t);
+    if( !t.is(VT::iSTRING,VT::iCHAR) ) return tx;
     std::string ret;
-    for( size_t i = 1; i < t.tx.size(); i++ ) switch( char c = t.tx[i]; c ) {
+    for( size_t i = 1; i < tx.size(); i++ ) switch( char c = tx[i]; c ) {
         case '\'': 
-            if( t.is(VT::iCHAR) ) i = t.tx.size();
+            if( t.is(VT::iCHAR) ) i = tx.size();
             else ret += c;
             break;
         case '"': 
-            if( t.is(VT::iSTRING) )i = t.tx.size();
+            if( t.is(VT::iSTRING) )i = tx.size();
             else ret += c;
             break; 
         case '\\':
-            c = t.tx[++i];
+            c = tx[++i];
             switch( c ) {
                 case '0':ret += '\0';break;
                 case 'a':ret += '\a';break;
@@ -616,7 +788,7 @@ std::string Xengine::extractText( const token& t ) {
                     c = 0;
                     for( int x = 0; x < 2; x++ ) {
                         c <<= 4;
-                        if(char x = t.tx[++i]; x >= '0' and x <= '9' ) c |= x-'0';
+                        if(char x = tx[++i]; x >= '0' and x <= '9' ) c |= x-'0';
                         else if( x >= 'a' and x <= 'z' ) c |= x-'a'+0x0a;
                         else if( x >= 'A' and x <= 'Z' ) c |= x-'A'+0x0a;
                         else c = -1;
@@ -631,60 +803,6 @@ std::string Xengine::extractText( const token& t ) {
     return std::move(ret);
 }
 
-
-int Xengine::priority( const token& t ) {
-    int p = 0;  
-    #warning [TODO]添加了好多运算符,这个方法待更新
-
-    /**
-     * 所有运算符
-     * p越小,优先级越高
-     */
-    while( true ) {
-        if( !t.is(CT::OPERATOR) ) break;
-        p += 1;
-
-        if( t.is(VT::MEMBER) )break;
-        p += 1;
-        //if( t.is(VN::INDEX) ) break;p += 1;                   //单目运算符    后
-        if( t.is(VT::INCRESS,VT::DECRESS) ) break;
-        p += 1;       //单目运算符    前后
-        //if( t.is(VT::prePLUS, VT::preMINUS) ) break; 
-        p += 1;    //单目运算符    前
-        //if( t.is(VT::ADDRESS,VT::REFER) ) break;
-        p += 1;         //单目运算符    前
-        if( t.is(VT::NOT) ) break; 
-        p += 1;                      //单目运算符    前
-        if( t.is(VT::BITREV) ) break;
-        p += 1;                      //单目运算符    前
-        if( t.is(VT::SHL,VT::SHR) ) break;
-        p += 1;               //双目运算符    左结合
-        if( t.is(VT::BITAND) ) break;
-        p += 1;                      //双目运算符    左结合
-        if( t.is(VT::BITXOR) ) break;
-        p += 1;
-        if( t.is(VT::BITOR) ) break;
-        p += 1;
-        if( t.is(VT::MOL,VT::MUL,VT::DIV) ) break;
-        p += 1;
-        if( t.is(VT::PLUS,VT::MINUS) ) break;
-        p += 1;
-        //if( t.is(VT::AS) ) break;p += 1;
-        if( t.is(VT::RANGE) ) break;
-        p += 1;
-        if( t.is(CT::RELATION) ) break;
-        p += 1;
-        if( t.is(VT::AND) ) break;
-        p += 1;
-        if( t.is(VT::OR) ) break;
-        p += 1;
-        if( t.is(CT::ASSIGN) ) break;
-        p += 1;
-        break;
-    }
-    return p;
-}
-
 }
 
 #endif
\ No newline at end of file
@@ -32,38 +32,39 @@ void Yengine::smachine::stay(int c ) {
 }
 void Yengine::smachine::redu(int c, VN n ) {
     token node = token(n);
+    bool named = node.is(CT::OPL);
+    string text;
     if( c >= 0 ) {
         //node.insert( std::move(*it), 0 );
-        node.bl = it->bl;
-        node.bc = it->bc;
-        node.el = it->el;
-        node.ec = it->ec;
-        node.tx = it->tx;
+        node.bo = it->bo;
+        node.eo = it->eo;
+        if( named ) text = *it;
         it.r.remove(it.pos);
     }
     else {
         c = -c;
         if( it.pos > 0 ) {
-            node.bl = (it-1)->el;       //由于还不能确定状态中是否包含这个单词,所以不能直接囊括其坐标
-            node.bc = (it-1)->ec;
-            node.el = (it-1)->el;
-            node.ec = (it-1)->ec;
-            //node.tx = (it-1)->tx;
+            node.bo = (it-1)->eo;       //由于还不能确定状态中是否包含这个单词,所以不能直接囊括其坐标
+            node.eo = (it-1)->eo;
         }
     }
 
     while( c-- > 0 ) {
         while( states[-1].c-- > 0 ) {
             //node.insert( std::move(*(--it)), 0 );
-            node.bl = (it-1)->bl;
-            node.bc = (it-1)->bc;
-            if( isalnum(node.tx[0]) and isalnum((it-1)->tx.back()) ) node.tx = (it-1)->tx + " " + node.tx;
-            else node.tx = (it-1)->tx + node.tx;
+            node.bo = (it-1)->bo;
+            if( named ) {
+                string prev = *(it-1);
+                if( !text.empty() and !prev.empty() and isalnum(text[0]) and isalnum(prev.back()) ) text = prev + " " + text;
+                else text = prev + text;
+            }
             (--it).r.remove(it.pos);
         }
         states.remove(-1);
     }
     
+    /** 运算符标签作为名称使用,保留其书写形式,其余非终结符的书写形式只在诊断时由源码重新拼接 */
+    if( named ) node.tx = text;
     it.r.insert(std::move(node),it.pos);
 }
 int Yengine::smachine::size()const {
@@ -103,9 +104,9 @@ nameuc::atom Yengine::constructAtomicNameUseCase( tokens::iterator& it, Lengine:
             if( it->is(VT::SHR) ) {
                 it->tx = ">";
                 it.r.insert(*it,it.pos);
-                it->ec -= 1;
+                it->eo -= 1;
                 it->id = (it+1)->id = VT::GT;
-                (it+1)->bc += 1;
+                (it+1)->bo += 1;
             } else if( it->is(VT::GT) ) {
                 stack.redu(3,VN::NAMEUC_ATOM);
             } else if( it->is(VN::PROTO) ) {
@@ -574,8 +575,7 @@ $eproto Yengine::constructElementPrototype( tokens::iterator& it, Lengine::logs&
     } else {
         it.r.insert(*it,it.pos);
         it->id = VT::SPACE;
-        it->el = it->bl;
-        it->ec = it->bc;
+        it->eo = it->bo;
         it->tx = " ";
         ret->elmt = UDF;
     }
@@ -608,7 +608,7 @@ $eproto Yengine::constructElementPrototype( tokens::iterator& it, Lengine::logs&
 }
 
 $ModuleGranule Yengine::constructSyntaxTree( tokens& is, Lengine::logs& log ) {
-    if( is.size() < 2 or!is[0].is(VT::R_BEG) or !is[-1].is(VT::R_END) ) {
+    if( is.size() < 2 or !is[0].is(VT::R_BEG) or !is[-1].is(VT::R_END) ) {
         log( Lengine::E0 );
         return nullptr;
     }
@@ -617,13 +617,13 @@ $ModuleGranule Yengine::constructSyntaxTree( tokens& is, Lengine::logs& log ) {
      * 剔除注释和空白
      */
     #warning [TODO]: 将注释留给需要调试信息的地方,将注释和源码加入调试信息
-    for( auto i = is.begin(); i != is.end(); ) 
-        if( i->is(VT::COMMENT,VT::SPACE) ) is.remover(*i);
-        else i += 1;
+    is.remove_if([](const token& t){return t.is(VT::COMMENT,VT::SPACE);});
 
     auto it = is.begin();
     auto stack = smachine(it);
     $ModuleGranule ref = new ModuleGranule;
+    ref->memory = new arena;
+    arena::scope resident(ref->memory);
 
     stack.movi(1);
     while( stack.size() > 0 ) switch( (state)stack ) {
@@ -667,8 +667,410 @@ $ModuleGranule Yengine::constructSyntaxTree( tokens& is, Lengine::logs& log ) {
     return ref;
 }
 
+/**
+ * @struct duplicator : 复制器
+ * @desc :
+ *  逐个复制语法结构,记录每个原结构对应的副本
+ *  结构在其成员之前登记,所以成员的作用域总能被映射到副本中的上级结构
+ *  节点的作用域只能设置一次,所以节点总是被新构造,而不是从原结构拷贝构造
+ *  复制依据事物的类别进行,类别的分支中没有默认分支,新增的类别若未在此决定复制方式,编译失败
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wswitch"
+struct duplicator {
+    std::map<const thing*,anything> copies;
+
+    /** 副本中所有记号位置的偏移量,复用修改之后的结构时用于平移位置 */
+    int delta = 0;
+
+    token operator()( const token& o ) {
+        token r = o;
+        if( r.bo ) r.bo += delta, r.eo += delta;
+        return r;
+    }
+
+    tokens operator()( const tokens& o ) {
+        tokens r = o;
+        for( auto& t : r ) t = (*this)(t);
+        return r;
+    }
+
+    $scope scope( $scope sc ) {
+        if( auto it = copies.find(sc); it != copies.end() ) return ($node)it->second;
+        return sc;
+    }
+
+    template<typename T> T* make( const T& o ) {
+        auto r = new T;
+        copies[&o] = r;
+        r->setScope(scope(o.getScope()));
+        r->phrase = (*this)(o.phrase);
+        return r;
+    }
+
+    template<typename T> agent<T> operator()( const agent<T>& o ) {
+        return (agent<T>)copy((T*)o);
+    }
+
+    template<typename T> chainz<T> operator()( const chainz<T>& o ) {
+        chainz<T> r;
+        for( auto& i : o ) r << (*this)(i);
+        return r;
+    }
+
+    nameuc operator()( const nameuc& o ) {
+        nameuc r = o;
+        for( int i = 0; i < r.size(); i++ ) {
+            r[i].name = (*this)(r[i].name);
+            r[i].tmpl = (*this)(r[i].tmpl);
+        }
+        if( auto sc = o.getScope(); sc ) r.setScope(scope(sc));
+        return r;
+    }
+
+    void base( definition& r, const definition& o ) {
+        r.visibility = (*this)(o.visibility);
+        r.name = (*this)(o.name);
+        r.wrtno = o.wrtno;
+    }
+
+    void params( morpheme::plist& r, const morpheme::plist& o ) {
+        for( auto& p : o ) r << (*this)(p);
+        r.vargs = (*this)(o.vargs);
+    }
+
+    void signature( morpheme::opsig& r, const morpheme::opsig& o ) {
+        r.subtitle = (*this)(o.subtitle);
+        r.rproto = (*this)(o.rproto);
+        r.modifier = (*this)(o.modifier);
+        r.constraint = (*this)(o.constraint);
+    }
+
+    anything copy( thing* o ) {
+        if( !o ) return nullptr;
+        if( auto it = copies.find(o); it != copies.end() ) return it->second;
+        switch( o->category() ) {
+            case cthing::typeuc: {
+                auto& t = *($typeuc)o;
+                auto r = new typeuc;
+                copies[o] = r;
+                r->phrase = (*this)(t.phrase);
+                r->id = t.id;
+                r->name = (*this)(t.name);
+                r->sub = copy(t.sub);
+                return r;
+            }
+            case cthing::eproto: {
+                auto& e = *($eproto)o;
+                auto r = new eproto;
+                copies[o] = r;
+                r->phrase = (*this)(e.phrase);
+                r->elmt = e.elmt;
+                r->dtype = (*this)(e.dtype);
+                r->cons = (*this)(e.cons);
+                return r;
+            }
+            case cthing::ModuleSignature: {
+                auto& m = *($ModuleSignature)o;
+                auto r = new ModuleSignature(m.name);
+                copies[o] = r;
+                r->setScope(scope(m.getScope()));
+                r->phrase = (*this)(m.phrase);
+                r->entry = (*this)(m.entry);
+                r->deps = (*this)(m.deps);
+                return r;
+            }
+            case cthing::depdesc: {
+                auto& d = *($depdesc)o;
+                auto r = make(d);
+                r->name = (*this)(d.name);
+                r->alias = (*this)(d.alias);
+                r->dest = d.dest;
+                r->self = d.self;
+                r->mfrom = (*this)(d.mfrom);
+                return r;
+            }
+            case cthing::ClassDef: {
+                auto& c = *($ClassDef)o;
+                auto r = make(c);
+                base(*r,c);
+                r->alias = (*this)(c.alias);
+                r->abstract = (*this)(c.abstract);
+                r->tmpls = (*this)(c.tmpls);
+                r->targs = (*this)(c.targs);
+                r->predicates = c.predicates;
+                for( auto& e : r->predicates ) for( auto& p : e ) p.arg = (*this)(p.arg);
+                r->branchs = c.branchs;
+                for( auto& b : r->branchs ) b.index = (*this)(b.index);
+                r->supers = (*this)(c.supers);
+                r->instdefs = (*this)(c.instdefs);
+                r->metadefs = (*this)(c.metadefs);
+                r->internal = (*this)(c.internal);
+                r->usages = (*this)(c.usages);
+                return r;
+            }
+            case cthing::EnumDef: {
+                auto& d = *($EnumDef)o;
+                auto r = make(d);
+                base(*r,d);
+                r->items = (*this)(d.items);
+                return r;
+            }
+            case cthing::AttrDef: {
+                auto& d = *($AttrDef)o;
+                auto r = make(d);
+                base(*r,d);
+                r->meta = (*this)(d.meta);
+                r->proto = (*this)(d.proto);
+                r->offset = d.offset;
+                return r;
+            }
+            case cthing::MethodDef: {
+                auto& d = *($MethodDef)o;
+                auto r = make(d);
+                base(*r,d);
+                params(*r,d);
+                r->rproto = (*this)(d.rproto);
+                r->constraint = (*this)(d.constraint);
+                r->meta = (*this)(d.meta);
+                r->atomic = (*this)(d.atomic);
+                r->raw = (*this)(d.raw);
+                return r;
+            }
+            case cthing::OperatorDef: {
+                auto& d = *($OperatorDef)o;
+                auto r = make(d);
+                base(*r,d);
+                params(*r,d);
+                signature(*r,d);
+                r->action = (*this)(d.action);
+                return r;
+            }
+            case cthing::MethodImpl: {
+                auto& i = *($MethodImpl)o;
+                auto r = make(i);
+                params(*r,i);
+                r->cname = (*this)(i.cname);
+                r->name = (*this)(i.name);
+                r->rproto = (*this)(i.rproto);
+                r->constraint = (*this)(i.constraint);
+                r->body = (*this)(i.body);
+                return r;
+            }
+            case cthing::OperatorImpl: {
+                auto& i = *($OperatorImpl)o;
+                auto r = make(i);
+                params(*r,i);
+                signature(*r,i);
+                r->cname = (*this)(i.cname);
+                r->name = (*this)(i.name);
+                r->body = copy(i.body);
+                return r;
+            }
+            case cthing::ConstructorImpl: {
+                auto& i = *($ConstructorImpl)o;
+                auto r = make(i);
+                for( auto& c : i.construct ) r->construct << ConstructorImpl::ConstructInfo{(*this)(c.name),(*this)(c.ctor)};
+                r->initiate = (*this)(i.initiate);
+                return r;
+            }
+            case cthing::InsBlockImpl: {
+                auto& i = *($InsBlockImpl)o;
+                auto r = make(i);
+                r->impls = (*this)(i.impls);
+                return r;
+            }
+            case cthing::ConstructImpl: {
+                auto& i = *($ConstructImpl)o;
+                auto r = make(i);
+                r->name = (*this)(i.name);
+                r->proto = (*this)(i.proto);
+                r->init = (*this)(i.init);
+                return r;
+            }
+            case cthing::ExpressionImpl: {
+                auto& i = *($ExpressionImpl)o;
+                auto r = make(i);
+                r->type = i.type;
+                r->mean = (*this)(i.mean);
+                r->name = (*this)(i.name);
+                r->sub = (*this)(i.sub);
+                r->target = (*this)(i.target);
+                return r;
+            }
+            case cthing::FlowCtrlImpl: {
+                auto& i = *($FlowCtrlImpl)o;
+                auto r = make(i);
+                r->action = i.action;
+                r->label = (*this)(i.label);
+                r->expr = (*this)(i.expr);
+                return r;
+            }
+            case cthing::BranchImpl: {
+                auto& i = *($BranchImpl)o;
+                auto r = make(i);
+                r->exp = (*this)(i.exp);
+                r->first = (*this)(i.first);
+                r->secnd = (*this)(i.secnd);
+                return r;
+            }
+            case cthing::LoopImpl: {
+                auto& i = *(agent<LoopImpl>)o;
+                auto r = make(i);
+                r->imp = (*this)(i.imp);
+                r->cond = (*this)(i.cond);
+                return r;
+            }
+            /** 不会出现在语法树中的抽象类别,以及模块描述符等不属于语法树的事物,被副本共享 */
+            case cthing::unknown:
+            case cthing::thing:
+            case cthing::node:
+            case cthing::definition:
+            case cthing::module:
+            case cthing::implementation:
+            case cthing::ModuleGranule:
+            case cthing::imm:
+            case cthing::modesc:
+            case cthing::nameuc:
+            case cthing::tcp:
+            case cthing::arena:
+                return o;
+        }
+        return o;
+    }
+};
+#pragma GCC diagnostic pop
+
+$ModuleGranule Yengine::reconstructSyntaxTree( $ModuleGranule prev, tokens& is, const Xengine::edit& ed, Lengine::logs& log ) {
+    if( !prev or prev->getScope() or !prev->signature or ed.b < 0 ) return constructSyntaxTree(is,log);
+    if( ed.text.empty() and ed.b == ed.e ) return prev;
+
+    /** 复用的语法结构驻留在旧颗粒的内存场中,连续复用的次数过多时完整地重新分析,以免内存场的保留链条无限增长 */
+    if( !prev->memory or prev->memory->depth() >= 16 ) return constructSyntaxTree(is,log);
+    if( is.size() < 2 or !is[0].is(VT::R_BEG) or !is[-1].is(VT::R_END) ) {
+        log( Lengine::E0 );
+        return nullptr;
+    }
+
+    uint32_t base = is[0].bo, from = base + ed.b, to = base + ed.e;
+
+    /** 修改触及模块签名 */
+    if( !prev->signature->phrase.bo or !(prev->signature->phrase.eo < from) ) return constructSyntaxTree(is,log);
+
+    /** 划分顶层结构,lo和hi之间是受损区域 */
+    uint32_t lo = prev->signature->phrase.eo, hi = UINT32_MAX;
+    definitions fdefs, bdefs;
+    implementations fimpls, bimpls;
+    auto classify = [&]( auto a, auto& front, auto& back ) {
+        auto& p = a->phrase;
+        if( !p.bo ) return false;
+        if( p.eo < from ) {
+            front << a;
+            if( lo < p.eo ) lo = p.eo;
+        } else if( p.bo >= to ) {
+            back << a;
+            if( p.bo < hi ) hi = p.bo;
+        }
+        return true;
+    };
+    for( auto d : prev->defs ) if( !classify(d,fdefs,bdefs) ) return constructSyntaxTree(is,log);
+    for( auto i : prev->impls ) if( !classify(i,fimpls,bimpls) ) return constructSyntaxTree(is,log);
+
+    is.remove_if([](const token& t){return t.is(VT::COMMENT,VT::SPACE);});
+
+    /** 
+     * 修改之后的结构在新文本中的起点平移了修改的长度差
+     * 词法分析必须在新起点之前重新同步,且新记号序列在新起点处恰好是复用结构的起点
+     * 否则修改可能吞没了之后的结构,例如未闭合的注释,之后的内容全部重新分析 */
+    if( bdefs.size() or bimpls.size() ) {
+        hi += ed.delta();
+        bool intact = ed.s >= 0 and !(hi < base + ed.s);
+        if( intact ) for( auto& t : is ) if( !t.is(VT::R_BEG) and !(t.bo < hi) ) {
+            intact = t.bo == hi and t.is(VT::METHOD,VT::OPERATOR,VT::CLASS,VT::ENUM);
+            break;
+        }
+        if( !intact ) {
+            bdefs.clear();
+            bimpls.clear();
+            hi = UINT32_MAX;
+        }
+    }
+
+    /** 截取受损区域的记号 */
+    tokens part;
+    part << is[0];
+    for( auto& t : is ) if( !t.is(VT::R_BEG,VT::R_END) and !(t.bo < lo) and t.bo < hi ) part << t;
+    part << is[-1];
+    if( hi != UINT32_MAX ) part[-1].bo = part[-1].eo = hi;
+
+    /** 
+     * 语法树被就地更新,复用的结构及其内部的名称都以旧颗粒为作用域,无需重新设置
+     * 新的结构也以旧颗粒为作用域构建,全部构建成功之后才替换旧颗粒的内容,失败时旧颗粒保持不变 */
+    $arena memory = new arena;
+    memory->retain(prev->memory);
+    arena::scope resident(memory);
+    definitions defs = fdefs;
+    implementations impls = fimpls;
+
+    /** 修改改变了文本长度时,复用的结构被复制到新的内存场中,副本中的记号位置随之平移 */
+    if( ed.delta() != 0 and (bdefs.size() or bimpls.size()) ) {
+        duplicator dup;
+        dup.delta = ed.delta();
+        bdefs = dup(bdefs);
+        bimpls = dup(bimpls);
+    }
+
+    for( auto it = part.begin()+1; !it->is(VT::R_END); ) {
+        if( it->is(VT::METHOD) ) {
+            auto met = constructMethodImplementation(it,log,prev);
+            if( !met ) return nullptr;
+            impls << ($implementation)met;
+        } else if( it->is(VT::OPERATOR) ) {
+            auto op = constructOperatorImplementation(it,log,prev);
+            if( !op ) return nullptr;
+            impls << ($implementation)op;
+        } else if( it->is(VT::CLASS) ) {
+            auto cls = constructClassDefinition(it,log,prev,0);
+            if( !cls ) return nullptr;
+            defs << ($definition)cls;
+        } else if( it->is(VT::ENUM) ) {
+            auto enm = constructEnumDefinition(it,log,prev,0);
+            if( !enm ) return nullptr;
+            defs << ($definition)enm;
+        } else if( it->is(VN::METHOD,VN::CLASS,VN::ENUM,VN::OPERATOR) ) {
+            it += 1;
+        } else {
+            log(Lengine::E201,*it);
+            return nullptr;
+        }
+    }
+
+    prev->memory = memory;
+    prev->defs = defs + bdefs;
+    prev->impls = impls + bimpls;
+    prev->phrase.eo = is[-1].eo;
+    return prev;
+}
+
+$ModuleGranule Yengine::duplicateSyntaxTree( $ModuleGranule origin ) {
+    if( !origin ) return nullptr;
+    $ModuleGranule ref = new ModuleGranule;
+    ref->memory = new arena;
+    arena::scope resident(ref->memory);
+
+    duplicator dup;
+    dup.copies[origin] = ref;
+    ref->phrase = origin->phrase;
+    ref->desc = origin->desc;
+    ref->document = origin->document;
+    ref->signature = dup(origin->signature);
+    ref->defs = dup(origin->defs);
+    ref->impls = dup(origin->impls);
+    return ref;
+}
+
 $ModuleSignature Yengine::detectModuleSignature( tokens& is, Lengine::logs& log ) {
-    if( is.size() < 2 or!is[0].is(VT::R_BEG) or !is[-1].is(VT::R_END) ) {
+    if( is.size() < 2 or !is[0].is(VT::R_BEG) or !is[-1].is(VT::R_END) ) {
         log( Lengine::E0 );
         return nullptr;
     }
@@ -677,9 +1079,7 @@ $ModuleSignature Yengine::detectModuleSignature( tokens& is, Lengine::logs& log
      * 剔除注释和空白
      */
      #warning [TODO]: 将注释留给需要调试信息的地方,将注释和源码加入调试信息
-    for( auto i = is.begin(); i != is.end(); ) 
-        if( i->is(VT::COMMENT,VT::SPACE) ) is.remover(*i);
-        else i += 1;
+    is.remove_if([](const token& t){return t.is(VT::COMMENT,VT::SPACE);});
 
     auto it = is.begin()+1;
     return constructModuleSignature( it, log, nullptr );
@@ -1575,296 +1975,308 @@ $ConstructorImpl Yengine::constructConstructorImplementation( tokens::iterator&
     return ret;
 }
 
+/**
+ * @struct binding : 结合力
+ * @desc :
+ *  中缀运算符对左右两侧算子的结合力,结合力越大,运算符越优先与算子结合
+ *  左结合的运算符两侧结合力相同,右结合的运算符右侧结合力更小
+ *  结合力为0的终结符不是中缀运算符
+ */
+struct binding {
+    short   left;
+    short   right;
+};
+
+/**
+ * @struct precedence : 优先级表
+ * @desc :
+ *  以终结符为下标的结合力表,以及前缀运算符对其算子的结合力
+ *  后缀运算,下标运算,成员运算和调用在构建算子时处理,比所有中缀运算符都优先
+ */
+struct precedence {
+    binding infix[(int)VT::DO+1];
+    short   prefix;
+};
+
+/**
+ * @struct tier : 优先级梯度
+ */
+struct tier {
+    VT      id;
+    short   level;      //优先级,越大越优先
+    bool    rassoc;     //是否右结合
+};
+
+/**
+ * @member tiers : 中缀运算符的优先级梯度
+ * @desc :
+ *  从最松散的运算符到最紧密的运算符依次排列,同一行的运算符优先级相同
+ *  赋值运算符右结合,其余运算符左结合,前缀运算符比所有中缀运算符都优先
+ */
+static constexpr tier tiers[] = {
+    {VT::WHERE,1,false},
+    {VT::ASSIGN,2,true},{VT::ASSIGN_bAND,2,true},{VT::ASSIGN_bOR,2,true},{VT::ASSIGN_bXOR,2,true},
+    {VT::ASSIGN_SHL,2,true},{VT::ASSIGN_SHR,2,true},{VT::ASSIGN_PLUS,2,true},{VT::ASSIGN_MINUS,2,true},
+    {VT::ASSIGN_MUL,2,true},{VT::ASSIGN_DIV,2,true},{VT::ASSIGN_MOL,2,true},
+    {VT::OR,3,false},
+    {VT::AND,4,false},
+    {VT::LT,5,false},{VT::LE,5,false},{VT::GT,5,false},{VT::GE,5,false},{VT::EQ,5,false},{VT::NE,5,false},
+    {VT::RANGE,6,false},
+    {VT::AS,7,false},{VT::TREAT,7,false},
+    {VT::PLUS,8,false},{VT::MINUS,8,false},
+    {VT::MOL,9,false},{VT::MUL,9,false},{VT::DIV,9,false},
+    {VT::BITOR,10,false},
+    {VT::BITXOR,11,false},
+    {VT::BITAND,12,false},
+    {VT::SHL,13,false},{VT::SHR,13,false},
+};
+
+static constexpr precedence generatePrecedence() {
+    precedence p = {};
+    short top = 0;
+    for( auto& t : tiers ) {
+        p.infix[(int)t.id] = {(short)(t.level*2),(short)(t.level*2-(t.rassoc?1:0))};
+        if( t.level > top ) top = t.level;
+    }
+    p.prefix = (top+1)*2;
+    return p;
+}
+
+static constexpr auto priority = generatePrecedence();
+
+/**
+ * @method enclose : 概括记号
+ * @desc :
+ *  产生一个覆盖[b,e)之间所有记号的非终结符,坐标的规则与状态机的归约相同
+ *  非终结符不携带文本,所以概括的开销与表达式的长度无关
+ */
+static token enclose( const tokens& ts, int b, int e, VN n ) {
+    token node = token(n);
+    node.bo = ts[b].bo;
+    node.eo = ts[e-1].eo;
+    return node;
+}
+
 $ExpressionImpl Yengine::constructExpressionImplementation( tokens::iterator& it, Lengine::logs& log, $scope scope ) {
-    smachine stack = it;
+    int b = it.pos;
+    auto ret = constructExpressionImplementation(it,log,scope,0);
+    if( !ret ) return nullptr;
+
+    /** 整个表达式被一次性归约为一个非终结符,非终结符占据第一个记号的位置,其余记号只前移一次 */
+    it.r[b] = ret->phrase;
+    it.r.remove(b+1,it.pos-b-1);
+    it.pos = b;
+    ret->phrase = *it;
+    return ret;
+}
+
+$ExpressionImpl Yengine::constructExpressionImplementation( tokens::iterator& it, Lengine::logs& log, $scope scope, int power ) {
+    int b = it.pos;
+    auto ret = constructExpressionOperand(it,log,scope);
+    if( !ret ) return nullptr;
+
+    while( it->is(VN::TERMINAL) ) {
+        auto& bind = priority.infix[(int)it->id];
+        if( bind.left <= power ) break;
+        if( it->is(VT::TREAT) ) {
+            return nullptr;
+            #warning [TODO]: 分析类型转换
+        }
+
+        $ExpressionImpl nr = new ExpressionImpl;
+        nr->setScope(scope);
+        nr->sub << ret;
+        if( it->is(VT::AS) ) {
+            nr->type = ExpressionImpl::CONVERT;
+            it += 1;
+            bool absorb = it->is(VT::CLASS);
+            if( absorb ) it += 1;
+            nr->target = constructElementPrototype(it,log,scope,absorb);
+            if( !nr->target ) return nullptr;
+            it += 1;
+        } else {
+            nr->mean = *it;
+            nr->type = it->is(CT::ASSIGN)?ExpressionImpl::ASSIGN:ExpressionImpl::INFIX;
+            it += 1;
+            auto rhs = constructExpressionImplementation(it,log,scope,bind.right);
+            if( !rhs ) return nullptr;
+            nr->sub << rhs;
+        }
+        ret = nr;
+        ret->phrase = enclose(it.r,b,it.pos,VN::EXPRESSION);
+    }
+
+    return ret;
+}
+
+$ExpressionImpl Yengine::constructExpressionOperand( tokens::iterator& it, Lengine::logs& log, $scope scope ) {
+    int b = it.pos;
     $ExpressionImpl ret = new ExpressionImpl;
-    stack.movi(1,0);
+    ret->setScope(scope);
 
-    while( stack.size() > 0 ) switch( (state)stack ) {
-        case 1 :
-            if( it->is(VT::CLASS) ) {
-                stack.stay();
-                ret->name = constructNameUseCase(it,log,scope,true);
-                if( !ret->name ) return nullptr;
-            } else if( it->is(VT::LABEL) ) {
-                ret->name = constructNameUseCase(it,log,scope,false);
-                if( !ret->name ) return nullptr;
-            } else if( it->is(VN::NAMEUC) ) {
-                ret->type = ExpressionImpl::NAMEUSAGE;
-                stack.redu(0,VN::EXPRESSION);
-            } else if( it->is(CT::CONSTANT,VT::iTHIS)) {
-                ret->type = ExpressionImpl::VALUE;
-                ret->mean = *it;
-                stack.redu(0,VN::EXPRESSION);
-            } else if( it->is(CT::PREFIX) ) {
-                ret->type = ExpressionImpl::PREFIX;
-                ret->mean = *it;
-                stack.movi(2);
-            } else if( it->is(VT::OPENS) ) {
-                ret->type = ExpressionImpl::SCTOR;
-                stack.movi(13);
-            } else if( it->is(VT::OPENL) ) {
-                ret->type = ExpressionImpl::LCTOR;
-                stack.movi(18);
-            } else if( it->is(VT::OPENA) ) {
-                stack.movi(3);
-            } else if( it->is(VN::EXPRESSION) ) {
-                stack.movi(5);
-            } else {
-                log(Lengine::E2025,*it);
-                return nullptr;
-            } break;
-        case 2 :
-            if( it->is(VN::EXPRESSION) ) {
-                stack.redu(1,VN::EXPRESSION);
-            } else if( auto sub = constructExpressionImplementation(it,log,scope); sub ) {
-                ret->sub << sub;
-            } else {
-                return nullptr;
-            } break;
-        case 3 : 
-            if( ret = constructExpressionImplementation(it,log,scope); ret ) {
-                stack.movi(4);
-            } else {
-                return nullptr;
-            } break;
-        case 4 :
-            if( it->is(VT::CLOSEA) ) {
-                stack.redu(2,VN::EXPRESSION);
-            } else {
-                #warning [TODO]: 报错 ')' missing
-                log(Lengine::E202,")",*it);
-                return nullptr;
-            } break;
-        case 5 :
-            if( it->is(CT::SUFFIX) ) {
-                $ExpressionImpl nr = new ExpressionImpl;
-                nr->type = ExpressionImpl::SUFFIX;
-                nr->mean = *it;
-                nr->sub << ret;
-                ret->phrase = *(it-1);
-                ret->setScope(scope);
-                ret = nr;
-                stack.redu(1,VN::EXPRESSION);
-            } else if( it->is(VT::TREAT) ) {
-                return nullptr;
-                #warning [TODO]: 分析类型转换
-            } else if( it->is(VT::OPENL) ) {
-                $ExpressionImpl nr = new ExpressionImpl;
-                nr->type = ExpressionImpl::SUFFIX;
-                nr->mean = *it;
-                nr->sub << ret;
-                ret->phrase = *(it-1);
-                ret->setScope(scope);
-                ret = nr;
-                stack.movi(10);
-            } else if( it->is(CT::INFIX) ) {
-                auto prev = prio(*(it-2));
-                if( prev and prev < prio(*it)) {
-                    stack.redu(-2,VN::EXPRESSION);
-                } else if( it->is(VT::MEMBER) ) {
-                    $ExpressionImpl nr = new ExpressionImpl;
-                    nr->type = ExpressionImpl::MEMBER;
-                    nr->sub << ret;
-                    ret->phrase = *(it-1);
-                    ret->setScope(scope);
-                    ret = nr;
-                    stack.movi(9);
-                } else {
-                    $ExpressionImpl nr = new ExpressionImpl;
-                    nr->mean = *it;
-                    nr->type = it->is(CT::ASSIGN)?ExpressionImpl::ASSIGN:ExpressionImpl::INFIX;
-                    nr->sub << ret;
-                    ret->phrase = *(it-1);
-                    ret->setScope(scope);
-                    ret = nr;
-                    stack.movi(8);
-                }
-            } else if( it->is(VT::OPENA) ) {
-                auto nr = new ExpressionImpl;
-                nr->type = ExpressionImpl::CALL;
-                nr->sub << ret;
-                ret->phrase = *(it-1);
-                ret->setScope(scope);
-                ret = nr;
-                stack.movi(6);
-            } else if( it->is(VT::AS) ) {
-                auto prev = prio(*(it-2));
-                if( prev and prev < prio(*it)) {
-                    stack.redu(-2,VN::EXPRESSION);
-                } else {
-                    auto nr = new ExpressionImpl;
-                    nr->type = ExpressionImpl::CONVERT;
-                    nr->sub << ret;
-                    ret->phrase = *(it-1);
-                    ret->setScope(scope);
-                    ret = nr;
-                    stack.movi(12);
-                }
-            } else {
-                stack.redu(-2,VN::EXPRESSION);
-            } break;
-        case 6 :
-            if( it->is(VT::CLOSEA) ) {
-                stack.redu(2,VN::EXPRESSION);
-            } else if( it->is(VN::EXPRESSION) ) {
-                stack.movi(7);
-            } else if( auto sub = constructExpressionImplementation(it,log,scope); sub ) {
-                ret->sub << sub;
-            } else {
-                return nullptr;
-            } break;
-        case 7 :
-            if( it->is(VT::COMMA) ) {
-                stack.stay();
-                if( auto sub = constructExpressionImplementation(it,log,scope); sub ) ret->sub << sub;
-                else return nullptr;
-            } else if( it->is(VN::EXPRESSION) ) {
-                stack.stay();
-            } else if( it->is(VT::CLOSEA) ) {
-                stack.redu(3,VN::EXPRESSION);
-            } else {
-                return nullptr;
-            } break;
-        case 8 : 
-            if( it->is(VN::EXPRESSION) ) {
-                stack.redu(2,VN::EXPRESSION);
-            } else {
-                ret->sub << constructExpressionImplementation( it, log, scope );
-                if( !ret->sub[-1] ) return nullptr;
-            } break;
-        case 9 :
-            if( it->is(VT::LABEL) ) {
-                ret->mean = *it;
-                stack.redu(2,VN::EXPRESSION);
-            } else {
-                log(Lengine::E2028,*it);
-                return nullptr;
-            } break;
-        case 10:
-            if( it->is(VN::EXPRESSION) ) {
-                stack.movi(11);
-            } else if( auto id = constructExpressionImplementation(it, log, scope ); id ) {
-                ret->sub << id;
-            } else {
-                return nullptr;
-            } break;
-        case 11:
-            if( it->is(VT::CLOSEL) ) {
-                stack.redu(3,VN::EXPRESSION);
-            } else {
-                log(Lengine::E202,"]",*it);
-                return nullptr;
-            } break;
-        case 12:
-            if( it->is(VN::PROTO) ) {
-                stack.redu(2,VN::EXPRESSION);
-            } else if( it->is(VT::CLASS) ) {
-                stack.stay();
-                ret->target = constructElementPrototype(it,log,scope,true);
-                if( !ret->target ) return nullptr;
-            } else if( ret->target = constructElementPrototype(it,log,scope,false); !ret->target ) {
-                return nullptr;
-            } break;
-        case 13:
-            if( it->is(VT::LABEL) ) {
-                if( (it+1)->is(VT::COLON) ) {
-                    stack.movi(15,0);
-                } else {
-                    ret->name = constructNameUseCase(it,log,scope,true);
-                    if( !ret->name ) return nullptr;
-                }
-            } else if( it->is(VN::NAMEUC,VN::EXPRESSION) ) {
-                stack.movi(14);
-            } else if( it->is(VT::CLOSES) ) {
-                stack.redu(1,VN::EXPRESSION);
+    if( it->is(VT::CLASS,VT::LABEL) ) {
+        ret->type = ExpressionImpl::NAMEUSAGE;
+        bool absorb = it->is(VT::CLASS);
+        if( absorb ) it += 1;
+        if( it->is(VT::LABEL) and !(it+1)->is(VT::SCOPE) and !(absorb and (it+1)->is(VT::LT)) ) {
+            /** 单独的标识符直接构成名称用例,不必归约记号序列 */
+            ret->name = nameuc(nameuc::atom(*it));
+            ret->name.setScope(scope);
+            ret->name.phrase = enclose(it.r,it.pos,it.pos+1,VN::NAMEUC);
+        } else {
+            ret->name = constructNameUseCase(it,log,scope,absorb);
+            if( !ret->name ) return nullptr;
+        }
+        it += 1;
+    } else if( it->is(CT::CONSTANT,VT::iTHIS) ) {
+        ret->type = ExpressionImpl::VALUE;
+        ret->mean = *it;
+        it += 1;
+    } else if( it->is(CT::PREFIX) ) {
+        ret->type = ExpressionImpl::PREFIX;
+        ret->mean = *it;
+        it += 1;
+        auto sub = constructExpressionImplementation(it,log,scope,priority.prefix);
+        if( !sub ) return nullptr;
+        ret->sub << sub;
+        ret->phrase = enclose(it.r,b,it.pos,VN::EXPRESSION);
+        return ret;
+    } else if( it->is(VT::OPENA) ) {
+        it += 1;
+        ret = constructExpressionImplementation(it,log,scope,0);
+        if( !ret ) return nullptr;
+        if( !it->is(VT::CLOSEA) ) {
+            log(Lengine::E202,")",*it);
+            return nullptr;
+        }
+        it += 1;
+    } else if( it->is(VT::OPENS) ) {
+        ret->type = ExpressionImpl::SCTOR;
+        it += 1;
+        if( it->is(VT::LABEL) and !(it+1)->is(VT::COLON) ) {
+            ret->name = constructNameUseCase(it,log,scope,true);
+            if( !ret->name ) return nullptr;
+            it += 1;
+        }
+
+        /** 类名与构造对之间,以及构造对之间,必须书写分隔符 */
+        bool open = !ret->name;
+        while( !it->is(VT::CLOSES) ) {
+            if( !open and it->is(VT::COMMA,VT::BITOR) ) {
+                open = true;
+                it += 1;
+            } else if( open and it->is(VT::LABEL) and (it+1)->is(VT::COLON) ) {
+                int bb = it.pos;
+                $ExpressionImpl bundle = new ExpressionImpl;
+                bundle->setScope(scope);
+                bundle->type = ExpressionImpl::BUNDLE;
+                bundle->mean = *it;
+                it += 2;
+                auto arg = constructExpressionImplementation(it,log,scope,0);
+                if( !arg ) return nullptr;
+                bundle->sub << arg;
+                bundle->phrase = enclose(it.r,bb,it.pos,VN::EXPRESSION);
+                ret->sub << bundle;
+                open = false;
             } else {
                 log(Lengine::E201,*it);
                 return nullptr;
-            } break;
-        case 14:
-            if( it->is(VT::CLOSES) ) {
-                stack.redu(2,VN::EXPRESSION);
-            } else if( it->is(VT::COMMA,VT::BITOR) ) {
-                stack.movi(15);
-            } else if( it->is(VN::EXPRESSION) ) {
-                stack.stay();
-            } else {
+            }
+        }
+        it += 1;
+    } else if( it->is(VT::OPENL) ) {
+        ret->type = ExpressionImpl::LCTOR;
+        it += 1;
+        if( it->is(VT::CLASS) ) {
+            it += 1;
+            if( !it->is(VT::LABEL) ) {
                 log(Lengine::E201,*it);
                 return nullptr;
-            } break;
-        case 15:
-            if( it->is(VT::LABEL) ) {
-                ret->sub.construct(-1);
-                ret->sub[-1]->setScope(scope);
-                ret->sub[-1]->type = ExpressionImpl::BUNDLE;
-                ret->sub[-1]->mean = *it;
-                stack.movi(16);
-            } else if( it->is(VT::CLOSES) ) {
-                stack.redu(-1,VN::EXPRESSION);
-            } else if( it->is(VN::EXPRESSION) ) {
-                ret->sub[-1]->phrase = *it;
-                stack.redu(1,VN::EXPRESSION);
-            } else {
+            }
+            ret->name = constructNameUseCase(it,log,scope,true);
+            if( !ret->name ) return nullptr;
+            it += 1;
+            if( !it->is(VT::BITOR,VT::CLOSEL) ) {
                 log(Lengine::E201,*it);
                 return nullptr;
-            } break;
-        case 16:
-            if( it->is(VT::COLON) ) {
-                stack.movi(17);
+            }
+        }
+
+        /** 类名与元素之间,以及元素之间,必须书写分隔符 */
+        bool open = !ret->name;
+        while( !it->is(VT::CLOSEL) ) {
+            if( !open and it->is(VT::COMMA,VT::BITOR) ) {
+                open = true;
+                it += 1;
+            } else if( open ) {
+                auto arg = constructExpressionImplementation(it,log,scope,0);
+                if( !arg ) return nullptr;
+                ret->sub << arg;
+                open = false;
             } else {
                 log(Lengine::E201,*it);
                 return nullptr;
-            } break;
-        case 17:
-            if( it->is(VN::EXPRESSION) ) {
-                stack.redu(2,VN::EXPRESSION);
-            } else if( auto arg = constructExpressionImplementation(it,log,scope); arg ) {
-                ret->sub[-1]->sub << arg;
-            } else {
-                return nullptr;
-            } break;
-        case 18:
-            if( it->is(VT::CLASS) ) {
-                stack.movi(19);
-            } else {
-                stack.movi(20,0);
-            } break;
-        case 19:
-            if( it->is(VT::LABEL) ) {
-                ret->name = constructNameUseCase(it,log,scope,true);
-                if( !ret->name ) return nullptr;
-            } else if( it->is(VN::NAMEUC) ) {
-                stack.movi(20);
-                if( !it->is(VT::BITOR,VT::CLOSEL) ) {
-                    log(Lengine::E201,*it);
-                    return nullptr;
-                }
-            } else {
-                log(Lengine::E201,*it);
+            }
+        }
+        it += 1;
+    } else {
+        log(Lengine::E2025,*it);
+        return nullptr;
+    }
+
+    while( it->is(CT::SUFFIX,VT::OPENL,VT::MEMBER,VT::OPENA) ) {
+        ret->phrase = enclose(it.r,b,it.pos,VN::EXPRESSION);
+        $ExpressionImpl nr = new ExpressionImpl;
+        nr->setScope(scope);
+        nr->sub << ret;
+        ret = nr;
+
+        if( it->is(CT::SUFFIX) ) {
+            ret->type = ExpressionImpl::SUFFIX;
+            ret->mean = *it;
+            it += 1;
+        } else if( it->is(VT::OPENL) ) {
+            ret->type = ExpressionImpl::SUFFIX;
+            ret->mean = *it;
+            it += 1;
+            auto index = constructExpressionImplementation(it,log,scope,0);
+            if( !index ) return nullptr;
+            ret->sub << index;
+            if( !it->is(VT::CLOSEL) ) {
+                log(Lengine::E202,"]",*it);
                 return nullptr;
-            } break;
-        case 20:
-            if( it->is(VT::CLOSEL) ) {
-                stack.redu(3,VN::EXPRESSION);
-            } else if( it->is(VT::BITOR,VT::COMMA) ) {
-                stack.movi(21);
-            } else {
-                log(Lengine::E201,*it);
+            }
+            it += 1;
+        } else if( it->is(VT::MEMBER) ) {
+            ret->type = ExpressionImpl::MEMBER;
+            it += 1;
+            if( !it->is(VT::LABEL) ) {
+                log(Lengine::E2028,*it);
                 return nullptr;
-            } break;
-        case 21:
-            if( it->is(VN::EXPRESSION) ) {
-                stack.redu(1,VN::EXPRESSION);
-            } else if( auto arg = constructExpressionImplementation(it,log,scope); arg ) {
+            }
+            ret->mean = *it;
+            it += 1;
+        } else {
+            ret->type = ExpressionImpl::CALL;
+            it += 1;
+            if( it->is(VT::CLOSEA) ) it += 1;
+            else while( true ) {
+                auto arg = constructExpressionImplementation(it,log,scope,0);
+                if( !arg ) return nullptr;
                 ret->sub << arg;
-            } else {
-                return nullptr;
-            } break;
+                if( it->is(VT::CLOSEA) ) {
+                    it += 1;
+                    break;
+                } else if( !it->is(VT::COMMA) ) {
+                    log(Lengine::E202,")",*it);
+                    return nullptr;
+                }
+                it += 1;
+            }
+        }
     }
 
-    ret->setScope(scope);
-    ret->phrase = *it;
+    ret->phrase = enclose(it.r,b,it.pos,VN::EXPRESSION);
     return ret;
 }
 
@@ -2307,61 +2719,6 @@ $LoopImpl Yengine::constructLoopimplementation( tokens::iterator& it, Lengine::l
     return ret ;
 }
 
-int Yengine::prio(const token& it)const {
-    int p = 0;  
-    #warning [TODO]添加了好多运算符,这个方法待更新
-
-
-    /**
-     * 所有运算符
-     * p越小,优先级越高
-     */
-    while( true ) {
-        if( !it.is(CT::OPERATOR) ) break;
-        p += 1;
-
-        if( it.is(VT::MEMBER) )break;
-        p += 1;
-        //if( it.is(VN::INDEX) ) break;p += 1;                   //单目运算符    后
-        if( it.is(VT::INCRESS,VT::DECRESS) ) break;
-        p += 1;       //单目运算符    前后
-        //if( it.is(VT::prePLUS, VT::preMINUS) ) break; 
-        p += 1;    //单目运算符    前
-        //if( it.is(VT::ADDRESS,VT::REFER) ) break;
-        p += 1;         //单目运算符    前
-        if( it.is(VT::NOT) ) break; 
-        p += 1;                      //单目运算符    前
-        if( it.is(VT::BITREV) ) break;
-        p += 1;                      //单目运算符    前
-        if( it.is(VT::SHL,VT::SHR) ) break;
-        p += 1;               //双目运算符    左结合
-        if( it.is(VT::BITAND) ) break;
-        p += 1;                      //双目运算符    左结合
-        if( it.is(VT::BITXOR) ) break;
-        p += 1;
-        if( it.is(VT::BITOR) ) break;
-        p += 1;
-        if( it.is(VT::MOL,VT::MUL,VT::DIV) ) break;
-        p += 1;
-        if( it.is(VT::PLUS,VT::MINUS) ) break;
-        p += 1;
-        if( it.is(VT::AS) ) break;
-        p += 1;
-        if( it.is(VT::RANGE) ) break;
-        p += 1;
-        if( it.is(CT::RELATION) ) break;
-        p += 1;
-        if( it.is(VT::AND) ) break;
-        p += 1;
-        if( it.is(VT::OR) ) break;
-        p += 1;
-        if( it.is(CT::ASSIGN) ) break;
-        p += 1;
-        break;
-    }
-    return p;
-}
-
 }
 
 #endif
\ No newline at end of file